@@ -0,0 +1,1064 @@
+#ifndef S21_BTREE_H_
+#define S21_BTREE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#include "../utils/defines.h"
+#include "../utils/pool_allocator.h"
+
+namespace s21 {
+// ключи, которые внутри узла можно сравнивать векторно
+template <typename Key, typename Compare>
+struct btree_simd_
+    : std::integral_constant<
+          bool, (std::is_same_v<Compare, std::less<Key>> ||
+                 std::is_same_v<Compare, std::less<>>)&&std::is_integral_v<Key> &&
+                    std::is_signed_v<Key> &&
+                    (sizeof(Key) == 4 || sizeof(Key) == 8)> {};
+
+#if defined(__SSE2__)
+/*
+ * Знаковое a > b по 64-битным дорожкам на одном SSE2: старшие половины
+ * сравниваются со знаком, младшие - без знака (сдвигом на 2^31), при равных
+ * старших решают младшие. Результат размножается на всю дорожку
+ */
+inline __m128i btree_cmpgt_epi64_(__m128i t_a, __m128i t_b) noexcept {
+#if defined(__SSE4_2__)
+  return _mm_cmpgt_epi64(t_a, t_b);
+#else
+  const __m128i bias = _mm_set_epi32(0, INT32_MIN, 0, INT32_MIN);
+  __m128i a = _mm_xor_si128(t_a, bias);
+  __m128i b = _mm_xor_si128(t_b, bias);
+  __m128i gt = _mm_cmpgt_epi32(a, b);
+  __m128i eq = _mm_cmpeq_epi32(a, b);
+  __m128i high_gt = _mm_shuffle_epi32(gt, _MM_SHUFFLE(3, 3, 1, 1));
+  __m128i high_eq = _mm_shuffle_epi32(eq, _MM_SHUFFLE(3, 3, 1, 1));
+  __m128i low_gt = _mm_shuffle_epi32(gt, _MM_SHUFFLE(2, 2, 0, 0));
+  return _mm_or_si128(high_gt, _mm_and_si128(high_eq, low_gt));
+#endif
+}
+#endif
+
+/*
+ * Количество ключей t_keys[0, t_n), меньших t_key (или не больших при
+ * t_inclusive). Ключи в узле отсортированы, поэтому это и есть позиция
+ * поиска. SSE2 сравнивает по 4 ключа int32 и по 2 ключа int64 (с SSE4.2
+ * int64 сравниваются одной инструкцией), хвост и остальные сборки считаются
+ * скалярно без ветвлений
+ */
+template <typename Key>
+std::size_t btree_count_(const Key* t_keys, std::size_t t_n, Key t_key,
+                         bool t_inclusive) noexcept {
+  std::size_t count = 0;
+  std::size_t i = 0;
+#if defined(__SSE2__)
+  if constexpr (sizeof(Key) == 4) {
+    const __m128i probe = _mm_set1_epi32(static_cast<std::int32_t>(t_key));
+    for (; i + 4 <= t_n; i += 4) {
+      __m128i block =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_keys + i));
+      __m128i hit = t_inclusive ? _mm_cmpgt_epi32(block, probe)
+                                : _mm_cmplt_epi32(block, probe);
+      int lanes = __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(hit)));
+      count += t_inclusive ? 4 - lanes : lanes;
+    }
+  } else if constexpr (sizeof(Key) == 8) {
+    const __m128i probe = _mm_set1_epi64x(static_cast<std::int64_t>(t_key));
+    for (; i + 2 <= t_n; i += 2) {
+      __m128i block =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_keys + i));
+      __m128i hit = t_inclusive ? btree_cmpgt_epi64_(block, probe)
+                                : btree_cmpgt_epi64_(probe, block);
+      int lanes = __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(hit)));
+      count += t_inclusive ? 2 - lanes : lanes;
+    }
+  }
+#endif
+  for (; i < t_n; ++i) {
+    count += t_inclusive ? !(t_key < t_keys[i]) : t_keys[i] < t_key;
+  }
+  return count;
+}
+
+// отображаемые значения листа лежат отдельно от ключей, у множеств их нет
+template <typename T, std::size_t N>
+struct btree_values_ {
+  T values[N];
+};
+
+template <std::size_t N>
+struct btree_values_<void, N> {};
+
+/*
+ * B+-дерево: все элементы лежат в листьях, связанных в двусвязный список,
+ * внутренние узлы хранят только разделители. Узел занимает около
+ * BTREE_NODE_BYTES байт, ключи внутри него идут подряд. Для T = void это
+ * множество. Key и T должны быть конструируемы по умолчанию и перемещаемы.
+ * Вставка и удаление инвалидируют итераторы.
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = pool_allocator<std::pair<const Key, T>>>
+class BTree {
+ protected:
+  static constexpr std::size_t kHeader = 5 * sizeof(void*);
+
+  static constexpr std::size_t slots_for(std::size_t t_slot) noexcept {
+    std::size_t n = defines::BTREE_NODE_BYTES > kHeader + 4 * t_slot
+                        ? (defines::BTREE_NODE_BYTES - kHeader) / t_slot
+                        : 4;
+    return n > 255 ? 255 : n;
+  }
+
+  static constexpr std::size_t mapped_size() noexcept {
+    if constexpr (std::is_void_v<T>) {
+      return 0;
+    } else {
+      return sizeof(T);
+    }
+  }
+
+  static constexpr std::size_t kLeafSlots = slots_for(sizeof(Key) +
+                                                      mapped_size());
+  static constexpr std::size_t kInnerSlots =
+      slots_for(sizeof(Key) + sizeof(void*));
+  static constexpr std::size_t kLeafMin = kLeafSlots / 2;
+  static constexpr std::size_t kInnerMin = kInnerSlots / 2;
+
+  struct inner_node;
+
+  struct node {
+    bool leaf;
+    std::size_t count = 0;
+    inner_node* parent = nullptr;
+
+    explicit node(bool t_leaf) noexcept : leaf(t_leaf) {}
+  };
+
+  struct leaf_node : node, btree_values_<T, kLeafSlots> {
+    leaf_node* prev = nullptr;
+    leaf_node* next = nullptr;
+    Key keys[kLeafSlots];
+
+    leaf_node() : node(true) {}
+  };
+
+  struct inner_node : node {
+    Key keys[kInnerSlots];
+    node* children[kInnerSlots + 1] = {};
+
+    inner_node() : node(false) {}
+  };
+
+  // оба вида узлов занимают блоки одного размера, чтобы их обслуживал один пул
+  struct node_block {
+    alignas(alignof(leaf_node) > alignof(inner_node)
+                ? alignof(leaf_node)
+                : alignof(inner_node)) unsigned char
+        bytes[sizeof(leaf_node) > sizeof(inner_node) ? sizeof(leaf_node)
+                                                     : sizeof(inner_node)];
+  };
+
+  using block_allocator_type = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<node_block>;
+  using block_traits = std::allocator_traits<block_allocator_type>;
+
+ public:
+  using key_type = Key;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using reference =
+      std::conditional_t<std::is_void_v<T>, const Key&,
+                         std::pair<const Key&, std::add_lvalue_reference_t<
+                                                   std::conditional_t<
+                                                       std::is_void_v<T>, int,
+                                                       T>>>>;
+
+  class iterator {
+   public:
+    using reference = typename BTree::reference;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+    using pointer = void;
+
+    // для operator-> у пар из ссылок
+    struct arrow_proxy {
+      reference ref;
+      std::remove_reference_t<reference>* operator->() noexcept {
+        return std::addressof(ref);
+      }
+    };
+
+    iterator() = default;
+    iterator(leaf_node* t_leaf, std::size_t t_pos, const BTree* t_tree)
+        : leaf_(t_leaf), pos_(t_pos), tree_(t_tree) {}
+
+    reference operator*() const { return element(leaf_, pos_); }
+
+    arrow_proxy operator->() const { return arrow_proxy{**this}; }
+
+    iterator& operator++() {
+      if (++pos_ == leaf_->count) {
+        leaf_ = leaf_->next;
+        pos_ = 0;
+      }
+      return *this;
+    }
+
+    iterator& operator--() {
+      if (leaf_ == nullptr) {
+        leaf_ = tree_->last_;
+        pos_ = leaf_->count;
+      } else if (pos_ == 0) {
+        leaf_ = leaf_->prev;
+        pos_ = leaf_->count;
+      }
+      --pos_;
+      return *this;
+    }
+
+    bool operator==(const iterator& t_other) const {
+      return leaf_ == t_other.leaf_ && pos_ == t_other.pos_;
+    }
+
+    bool operator!=(const iterator& t_other) const {
+      return !(*this == t_other);
+    }
+
+   private:
+    friend class BTree;
+
+    leaf_node* leaf_ = nullptr;
+    std::size_t pos_ = 0;
+    const BTree* tree_ = nullptr;
+  };
+
+ public:
+  BTree() : BTree(Compare(), Allocator()) {}
+
+  explicit BTree(const Allocator& t_alloc) : BTree(Compare(), t_alloc) {}
+
+  explicit BTree(const Compare& t_compare,
+                 const Allocator& t_alloc = Allocator())
+      : allocator_(t_alloc), compare_(t_compare) {}
+
+  ~BTree() { clear_btree(); }
+
+  allocator_type get_allocator() const { return allocator_type(allocator_); }
+
+  key_compare key_comp() const { return compare_; }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type max_size() const noexcept {
+    return block_traits::max_size(allocator_) * kLeafMin;
+  }
+
+  iterator begin() const noexcept { return iterator(first_, 0, this); }
+
+  iterator end() const noexcept { return iterator(nullptr, 0, this); }
+
+ protected:
+  static reference element(leaf_node* t_leaf, std::size_t t_pos) {
+    if constexpr (std::is_void_v<T>) {
+      return t_leaf->keys[t_pos];
+    } else {
+      return reference(t_leaf->keys[t_pos], t_leaf->values[t_pos]);
+    }
+  }
+
+  //  поиск внутри узла
+  template <typename K>
+  std::size_t rank_in(const Key* t_keys, std::size_t t_n, const K& t_key,
+                      bool t_inclusive) const {
+    if constexpr (btree_simd_<Key, Compare>::value &&
+                  std::is_same_v<K, Key>) {
+      return btree_count_(t_keys, t_n, t_key, t_inclusive);
+    } else {
+      std::size_t first = 0;
+      while (t_n > 0) {
+        std::size_t half = t_n / 2;
+        bool left = t_inclusive ? compare_(t_key, t_keys[first + half])
+                                : !compare_(t_keys[first + half], t_key);
+        if (left) {
+          t_n = half;
+        } else {
+          first += half + 1;
+          t_n -= half + 1;
+        }
+      }
+      return first;
+    }
+  }
+
+  // лист, в котором key лежит или должен лежать
+  template <typename K>
+  leaf_node* find_leaf(const K& t_key) const {
+    node* current = root_;
+    while (current && !current->leaf) {
+      inner_node* inner = static_cast<inner_node*>(current);
+      current = inner->children[rank_in(inner->keys, inner->count, t_key, true)];
+    }
+    return static_cast<leaf_node*>(current);
+  }
+
+  iterator normalize(leaf_node* t_leaf, std::size_t t_pos) const noexcept {
+    if (t_leaf && t_pos == t_leaf->count) {
+      t_leaf = t_leaf->next;
+      t_pos = 0;
+    }
+    return iterator(t_leaf, t_pos, this);
+  }
+
+  template <typename K>
+  iterator lower_bound_btree(const K& t_key) const {
+    leaf_node* leaf = find_leaf(t_key);
+    if (leaf == nullptr) return end();
+    return normalize(leaf, rank_in(leaf->keys, leaf->count, t_key, false));
+  }
+
+  template <typename K>
+  iterator upper_bound_btree(const K& t_key) const {
+    leaf_node* leaf = find_leaf(t_key);
+    if (leaf == nullptr) return end();
+    return normalize(leaf, rank_in(leaf->keys, leaf->count, t_key, true));
+  }
+
+  template <typename K>
+  iterator find_btree(const K& t_key) const {
+    iterator it = lower_bound_btree(t_key);
+    if (it.leaf_ && !compare_(t_key, it.leaf_->keys[it.pos_])) return it;
+    return end();
+  }
+
+  //  выделение узлов
+  /*
+   * Все узлы, которые может потребовать вставка, создаются до первого
+   * изменения дерева, поэтому нехватка памяти не оставляет его разрезанным
+   */
+  struct spare_nodes {
+    BTree* tree;
+    leaf_node* leaf = nullptr;
+    inner_node* inners[64] = {};
+    std::size_t count = 0;
+
+    explicit spare_nodes(BTree* t_tree) noexcept : tree(t_tree) {}
+    spare_nodes(const spare_nodes&) = delete;
+    spare_nodes& operator=(const spare_nodes&) = delete;
+
+    ~spare_nodes() {
+      if (leaf) tree->destroy_node(leaf);
+      while (count) tree->destroy_node(inners[--count]);
+    }
+
+    leaf_node* take_leaf() noexcept { return std::exchange(leaf, nullptr); }
+
+    inner_node* take_inner() noexcept { return inners[--count]; }
+  };
+
+  template <typename Node>
+  Node* create_node() {
+    node_block* block = block_traits::allocate(allocator_, 1);
+    try {
+      return ::new (static_cast<void*>(block)) Node();
+    } catch (...) {
+      block_traits::deallocate(allocator_, block, 1);
+      THROW_FURTHER;
+    }
+  }
+
+  void destroy_node(node* t_node) noexcept {
+    if (t_node->leaf) {
+      static_cast<leaf_node*>(t_node)->~leaf_node();
+    } else {
+      static_cast<inner_node*>(t_node)->~inner_node();
+    }
+    block_traits::deallocate(allocator_, reinterpret_cast<node_block*>(t_node),
+                             1);
+  }
+
+  // запас узлов для вставки в заполненный лист
+  void prepare_split(leaf_node* t_leaf, spare_nodes& t_spare) {
+    if (t_leaf->count < kLeafSlots) return;
+    t_spare.leaf = create_node<leaf_node>();
+    inner_node* parent = t_leaf->parent;
+    while (parent && parent->count == kInnerSlots) {
+      t_spare.inners[t_spare.count++] = create_node<inner_node>();
+      parent = parent->parent;
+    }
+    if (parent == nullptr) {
+      t_spare.inners[t_spare.count++] = create_node<inner_node>();
+    }
+  }
+
+  static std::size_t child_index(const inner_node* t_parent,
+                                 const node* t_child) noexcept {
+    std::size_t i = 0;
+    while (t_parent->children[i] != t_child) ++i;
+    return i;
+  }
+
+  //  вставка
+  // место для нового ключа: лист и позиция в нем, либо найденный равный ключ
+  struct insert_pos_ {
+    leaf_node* leaf;
+    std::size_t pos;
+    bool found;
+  };
+
+  template <typename K>
+  insert_pos_ find_insert_pos(const K& t_key) const {
+    if (root_ == nullptr) return {nullptr, 0, false};
+    // возрастающие ключи сразу уходят в конец последнего листа
+    if (compare_(last_->keys[last_->count - 1], t_key)) {
+      return {last_, last_->count, false};
+    }
+    leaf_node* leaf = find_leaf(t_key);
+    std::size_t pos = rank_in(leaf->keys, leaf->count, t_key, false);
+    bool found = pos < leaf->count && !compare_(t_key, leaf->keys[pos]);
+    return {leaf, pos, found};
+  }
+
+  // t_key и t_args собирают элемент, если такого ключа еще нет
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> emplace_unique_btree(K&& t_key, Args&&... t_args) {
+    insert_pos_ where = find_insert_pos(t_key);
+    if (where.found) {
+      return std::make_pair(iterator(where.leaf, where.pos, this), false);
+    }
+    return std::make_pair(
+        insert_at(where, std::forward<K>(t_key), std::forward<Args>(t_args)...),
+        true);
+  }
+
+  template <typename InputIt>
+  void insert_range_btree(InputIt t_first, InputIt t_last) {
+    for (; t_first != t_last; ++t_first) {
+      if constexpr (std::is_void_v<T>) {
+        emplace_unique_btree(*t_first);
+      } else {
+        emplace_unique_btree((*t_first).first, (*t_first).second);
+      }
+    }
+  }
+
+  template <typename K>
+  size_type erase_key_btree(const K& t_key) {
+    iterator it = find_btree(t_key);
+    if (it.leaf_ == nullptr) return 0;
+    erase_btree(it);
+    return 1;
+  }
+
+  /*
+   * Недостающие ключи переносятся сюда, оставшиеся сдвигаются к началу
+   * листьев t_other, после чего его внутренние узлы собираются заново из
+   * прежних. Элементы перемещаются, узлы t_other не выделяются
+   */
+  void merge_btree(BTree& t_other) {
+    if (this == &t_other || t_other.root_ == nullptr) return;
+    leaf_node* read = t_other.first_;
+    std::size_t r = 0;
+    leaf_node* write = read;
+    std::size_t w = 0;
+    size_type kept = 0;
+    auto keep = [&] {
+      if (read != write || r != w) move_slot(read, r, write, w);
+      ++kept;
+      if (++w == kLeafSlots) {
+        write = write->next;
+        w = 0;
+      }
+    };
+    try {
+      for (; read; read = read->next, r = 0) {
+        for (; r < read->count; ++r) {
+          Key& key = read->keys[r];
+          insert_pos_ where = find_insert_pos(key);
+          if (where.found) {
+            keep();
+          } else if constexpr (std::is_void_v<T>) {
+            insert_at(where, std::move(key));
+          } else {
+            insert_at(where, std::move(key), std::move(read->values[r]));
+          }
+        }
+      }
+    } catch (...) {
+      // неудачная вставка не трогает элемент, он остается в t_other
+      for (; read; read = read->next, r = 0) {
+        for (; r < read->count; ++r) keep();
+      }
+      t_other.rebuild_from_leaves(write, w, kept);
+      THROW_FURTHER;
+    }
+    t_other.rebuild_from_leaves(write, w, kept);
+  }
+
+  /*
+   * После уплотнения листья до t_write заполнены, в t_write лежит t_used
+   * элементов, дальше - только перемещенные. Хвост освобождается, последний
+   * лист добирает элементы у соседа, уровни над листьями строятся заново
+   * из прежних внутренних узлов: их число не растет, если листьев не больше
+   */
+  void rebuild_from_leaves(leaf_node* t_write, std::size_t t_used,
+                           size_type t_size) {
+    node* spare = nullptr;
+    collect_inners(root_, spare);
+    leaf_node* last = t_used ? t_write : (t_write ? t_write->prev : last_);
+    leaf_node* tail = last ? last->next : first_;
+    while (tail) destroy_node(std::exchange(tail, tail->next));
+    size_ = t_size;
+    if (last == nullptr) {
+      root_ = first_ = last_ = nullptr;
+      destroy_chain(spare);
+      return;
+    }
+    std::size_t leaves = 0;
+    for (leaf_node* leaf = first_; leaf != last; leaf = leaf->next, ++leaves) {
+      leaf->count = kLeafSlots;
+    }
+    ++leaves;
+    last->next = nullptr;
+    last_ = last;
+    for (std::size_t i = t_used; t_used && i < kLeafSlots; ++i) {
+      release_slot(last, i);
+    }
+    last->count = t_used ? t_used : kLeafSlots;
+    if (last->prev && last->count < kLeafMin) {
+      leaf_node* prev = last->prev;
+      std::size_t shift = kLeafMin - last->count;
+      move_slots(last, 0, last, shift, last->count);
+      move_slots(prev, prev->count - shift, last, 0, shift);
+      for (std::size_t i = prev->count - shift; i < prev->count; ++i) {
+        release_slot(prev, i);
+      }
+      prev->count -= shift;
+      last->count += shift;
+    }
+    build_levels(first_, leaves, spare);
+  }
+
+  // внутренние узлы поддерева в цепочку через children[0], листья не трогает
+  static void collect_inners(node* t_node, node*& t_chain) noexcept {
+    if (t_node == nullptr || t_node->leaf) return;
+    inner_node* inner = static_cast<inner_node*>(t_node);
+    for (std::size_t i = 0; i <= inner->count; ++i) {
+      collect_inners(inner->children[i], t_chain);
+    }
+    inner->children[0] = std::exchange(t_chain, inner);
+  }
+
+  /*
+   * Уровень из t_n узлов делится на равные группы не больше kInnerSlots + 1
+   * детей, каждая получает родителя. Листья уровня идут по next, внутренние
+   * узлы еще не собранного уровня - по временной ссылке в parent
+   */
+  void build_levels(node* t_level, std::size_t t_n, node* t_spare) {
+    bool leaves = true;
+    while (t_n > 1) {
+      std::size_t groups = (t_n + kInnerSlots) / (kInnerSlots + 1);
+      inner_node* head = nullptr;
+      inner_node* tail = nullptr;
+      node* child = t_level;
+      for (std::size_t g = 0; g < groups; ++g) {
+        inner_node* parent;
+        if (t_spare) {
+          parent = static_cast<inner_node*>(t_spare);
+          t_spare = parent->children[0];
+        } else {
+          parent = create_node<inner_node>();
+        }
+        std::size_t take = t_n / groups + (g < t_n % groups);
+        for (std::size_t i = 0; i < take; ++i) {
+          node* next = leaves ? static_cast<leaf_node*>(child)->next
+                              : static_cast<node*>(child->parent);
+          parent->children[i] = child;
+          if (i > 0) parent->keys[i - 1] = min_key(child);
+          child->parent = parent;
+          child = next;
+        }
+        for (std::size_t i = take - 1; i < kInnerSlots; ++i) {
+          parent->keys[i] = Key();
+        }
+        parent->count = take - 1;
+        parent->parent = nullptr;
+        (tail ? tail->parent : head) = parent;
+        tail = parent;
+      }
+      t_level = head;
+      t_n = groups;
+      leaves = false;
+    }
+    root_ = t_level;
+    root_->parent = nullptr;
+    destroy_chain(t_spare);
+  }
+
+  void destroy_chain(node* t_chain) noexcept {
+    while (t_chain) {
+      node* next = static_cast<inner_node*>(t_chain)->children[0];
+      destroy_node(t_chain);
+      t_chain = next;
+    }
+  }
+
+  static const Key& min_key(const node* t_node) noexcept {
+    while (!t_node->leaf) {
+      t_node = static_cast<const inner_node*>(t_node)->children[0];
+    }
+    return static_cast<const leaf_node*>(t_node)->keys[0];
+  }
+
+  /*
+   * Сначала выделяются узлы, затем собирается элемент, и только потом
+   * меняется дерево: при нехватке памяти t_key и t_args остаются нетронутыми
+   */
+  template <typename K, typename... Args>
+  iterator insert_at(insert_pos_ t_where, K&& t_key, Args&&... t_args) {
+    spare_nodes spare(this);
+    if (root_ == nullptr) {
+      spare.leaf = create_node<leaf_node>();
+    } else {
+      prepare_split(t_where.leaf, spare);
+    }
+    Key key(std::forward<K>(t_key));
+    std::conditional_t<std::is_void_v<T>, char, T> mapped(
+        std::forward<Args>(t_args)...);
+    if (root_ == nullptr) {
+      leaf_node* leaf = spare.take_leaf();
+      root_ = first_ = last_ = leaf;
+      t_where = {leaf, 0, false};
+    }
+
+    leaf_node* leaf = t_where.leaf;
+    std::size_t pos = t_where.pos;
+    if (leaf->count == kLeafSlots) {
+      leaf_node* right = spare.take_leaf();
+      if (leaf == last_ && pos == leaf->count) {
+        // дописывание в конец: новый лист вместо деления пополам,
+        // последовательная загрузка оставляет листья заполненными
+        link_leaf_after(leaf, right);
+        insert_child(leaf, key, right, spare);
+      } else {
+        split_leaf(leaf, right, spare);
+      }
+      if (pos >= leaf->count) {
+        pos -= leaf->count;
+        leaf = right;
+      }
+    }
+
+    for (std::size_t i = leaf->count; i > pos; --i) {
+      leaf->keys[i] = std::move(leaf->keys[i - 1]);
+      if constexpr (!std::is_void_v<T>) {
+        leaf->values[i] = std::move(leaf->values[i - 1]);
+      }
+    }
+    leaf->keys[pos] = std::move(key);
+    if constexpr (!std::is_void_v<T>) {
+      leaf->values[pos] = std::move(mapped);
+    }
+    ++leaf->count;
+    ++size_;
+    if (pos == 0 && leaf->parent) refresh_separator(leaf);
+    return iterator(leaf, pos, this);
+  }
+
+  // новый минимум листа мог оказаться левее разделителя над ним
+  void refresh_separator(leaf_node* t_leaf) {
+    node* child = t_leaf;
+    for (inner_node* parent = child->parent; parent;
+         child = parent, parent = parent->parent) {
+      std::size_t index = child_index(parent, child);
+      if (index > 0) {
+        if (compare_(t_leaf->keys[0], parent->keys[index - 1])) {
+          parent->keys[index - 1] = t_leaf->keys[0];
+        }
+        return;
+      }
+    }
+  }
+
+  void link_leaf_after(leaf_node* t_leaf, leaf_node* t_next) noexcept {
+    t_next->prev = t_leaf;
+    t_next->next = t_leaf->next;
+    if (t_leaf->next) {
+      t_leaf->next->prev = t_next;
+    } else {
+      last_ = t_next;
+    }
+    t_leaf->next = t_next;
+  }
+
+  void split_leaf(leaf_node* t_leaf, leaf_node* t_right, spare_nodes& t_spare) {
+    std::size_t mid = t_leaf->count / 2;
+    for (std::size_t i = mid; i < t_leaf->count; ++i) {
+      t_right->keys[i - mid] = std::move(t_leaf->keys[i]);
+      if constexpr (!std::is_void_v<T>) {
+        t_right->values[i - mid] = std::move(t_leaf->values[i]);
+      }
+    }
+    t_right->count = t_leaf->count - mid;
+    t_leaf->count = mid;
+    link_leaf_after(t_leaf, t_right);
+    insert_child(t_leaf, t_right->keys[0], t_right, t_spare);
+  }
+
+  // вешает t_right справа от t_left с разделителем t_separator
+  void insert_child(node* t_left, Key t_separator, node* t_right,
+                    spare_nodes& t_spare) {
+    inner_node* parent = t_left->parent;
+    if (parent == nullptr) {
+      inner_node* root = t_spare.take_inner();
+      root->keys[0] = std::move(t_separator);
+      root->children[0] = t_left;
+      root->children[1] = t_right;
+      root->count = 1;
+      t_left->parent = t_right->parent = root;
+      root_ = root;
+      return;
+    }
+
+    std::size_t index = child_index(parent, t_left);
+    inner_node* target = parent;
+    inner_node* sibling = nullptr;
+    Key up;
+    if (parent->count == kInnerSlots) {
+      // средний разделитель уходит наверх, правая половина - в sibling
+      std::size_t mid = kInnerSlots / 2;
+      sibling = t_spare.take_inner();
+      for (std::size_t i = mid + 1; i < parent->count; ++i) {
+        sibling->keys[i - mid - 1] = std::move(parent->keys[i]);
+      }
+      for (std::size_t i = mid + 1; i <= parent->count; ++i) {
+        sibling->children[i - mid - 1] = parent->children[i];
+        parent->children[i]->parent = sibling;
+      }
+      sibling->count = parent->count - mid - 1;
+      up = std::move(parent->keys[mid]);
+      parent->count = mid;
+      if (index > mid) {
+        target = sibling;
+        index -= mid + 1;
+      }
+    }
+
+    for (std::size_t i = target->count; i > index; --i) {
+      target->keys[i] = std::move(target->keys[i - 1]);
+      target->children[i + 1] = target->children[i];
+    }
+    target->keys[index] = std::move(t_separator);
+    target->children[index + 1] = t_right;
+    t_right->parent = target;
+    ++target->count;
+
+    if (sibling) insert_child(parent, std::move(up), sibling, t_spare);
+  }
+
+  //  удаление
+  void erase_btree(iterator t_pos) {
+    leaf_node* leaf = t_pos.leaf_;
+    for (std::size_t i = t_pos.pos_ + 1; i < leaf->count; ++i) {
+      leaf->keys[i - 1] = std::move(leaf->keys[i]);
+      if constexpr (!std::is_void_v<T>) {
+        leaf->values[i - 1] = std::move(leaf->values[i]);
+      }
+    }
+    --leaf->count;
+    release_slot(leaf, leaf->count);
+    --size_;
+
+    if (leaf == root_) {
+      if (leaf->count == 0) {
+        destroy_node(leaf);
+        root_ = first_ = last_ = nullptr;
+      }
+      return;
+    }
+    if (leaf->count < kLeafMin) rebalance_leaf(leaf);
+  }
+
+  // освободившийся слот не держит чужих ресурсов
+  static void release_slot(leaf_node* t_leaf, std::size_t t_pos) {
+    t_leaf->keys[t_pos] = Key();
+    if constexpr (!std::is_void_v<T>) {
+      t_leaf->values[t_pos] = T();
+    }
+  }
+
+  void rebalance_leaf(leaf_node* t_leaf) {
+    inner_node* parent = t_leaf->parent;
+    std::size_t index = child_index(parent, t_leaf);
+    leaf_node* left =
+        index > 0 ? static_cast<leaf_node*>(parent->children[index - 1])
+                  : nullptr;
+    leaf_node* right =
+        index < parent->count
+            ? static_cast<leaf_node*>(parent->children[index + 1])
+            : nullptr;
+
+    if (left && left->count > kLeafMin) {
+      move_slots(t_leaf, 0, t_leaf, 1, t_leaf->count);
+      move_slots(left, left->count - 1, t_leaf, 0, 1);
+      --left->count;
+      release_slot(left, left->count);
+      ++t_leaf->count;
+      parent->keys[index - 1] = t_leaf->keys[0];
+    } else if (right && right->count > kLeafMin) {
+      move_slots(right, 0, t_leaf, t_leaf->count, 1);
+      ++t_leaf->count;
+      move_slots(right, 1, right, 0, right->count - 1);
+      --right->count;
+      release_slot(right, right->count);
+      parent->keys[index] = right->keys[0];
+    } else if (left) {
+      merge_leaves(left, t_leaf, index - 1);
+    } else if (right) {
+      merge_leaves(t_leaf, right, index);
+    }
+  }
+
+  // переносит t_n слотов, перекрытие допустимо в пределах одного листа
+  static void move_slots(leaf_node* t_from, std::size_t t_from_pos,
+                         leaf_node* t_to, std::size_t t_to_pos,
+                         std::size_t t_n) {
+    if (t_from == t_to && t_to_pos > t_from_pos) {
+      for (std::size_t i = t_n; i > 0; --i) {
+        move_slot(t_from, t_from_pos + i - 1, t_to, t_to_pos + i - 1);
+      }
+    } else {
+      for (std::size_t i = 0; i < t_n; ++i) {
+        move_slot(t_from, t_from_pos + i, t_to, t_to_pos + i);
+      }
+    }
+  }
+
+  static void move_slot(leaf_node* t_from, std::size_t t_from_pos,
+                        leaf_node* t_to, std::size_t t_to_pos) {
+    t_to->keys[t_to_pos] = std::move(t_from->keys[t_from_pos]);
+    if constexpr (!std::is_void_v<T>) {
+      t_to->values[t_to_pos] = std::move(t_from->values[t_from_pos]);
+    }
+  }
+
+  // t_right вливается в t_left, разделитель t_index уходит из родителя
+  void merge_leaves(leaf_node* t_left, leaf_node* t_right,
+                    std::size_t t_index) {
+    move_slots(t_right, 0, t_left, t_left->count, t_right->count);
+    t_left->count += t_right->count;
+    t_left->next = t_right->next;
+    if (t_right->next) {
+      t_right->next->prev = t_left;
+    } else {
+      last_ = t_left;
+    }
+    destroy_node(t_right);
+    remove_from_inner(t_left->parent, t_index);
+  }
+
+  void remove_from_inner(inner_node* t_node, std::size_t t_index) {
+    for (std::size_t i = t_index + 1; i < t_node->count; ++i) {
+      t_node->keys[i - 1] = std::move(t_node->keys[i]);
+      t_node->children[i] = t_node->children[i + 1];
+    }
+    --t_node->count;
+    t_node->keys[t_node->count] = Key();
+
+    if (t_node == root_) {
+      if (t_node->count == 0) {
+        root_ = t_node->children[0];
+        root_->parent = nullptr;
+        destroy_node(t_node);
+      }
+      return;
+    }
+    if (t_node->count < kInnerMin) rebalance_inner(t_node);
+  }
+
+  void rebalance_inner(inner_node* t_node) {
+    inner_node* parent = t_node->parent;
+    std::size_t index = child_index(parent, t_node);
+    inner_node* left =
+        index > 0 ? static_cast<inner_node*>(parent->children[index - 1])
+                  : nullptr;
+    inner_node* right =
+        index < parent->count
+            ? static_cast<inner_node*>(parent->children[index + 1])
+            : nullptr;
+
+    if (left && left->count > kInnerMin) {
+      // поворот вправо через разделитель родителя
+      for (std::size_t i = t_node->count; i > 0; --i) {
+        t_node->keys[i] = std::move(t_node->keys[i - 1]);
+      }
+      for (std::size_t i = t_node->count + 1; i > 0; --i) {
+        t_node->children[i] = t_node->children[i - 1];
+      }
+      t_node->keys[0] = std::move(parent->keys[index - 1]);
+      t_node->children[0] = left->children[left->count];
+      t_node->children[0]->parent = t_node;
+      parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+      --left->count;
+      ++t_node->count;
+    } else if (right && right->count > kInnerMin) {
+      t_node->keys[t_node->count] = std::move(parent->keys[index]);
+      t_node->children[t_node->count + 1] = right->children[0];
+      right->children[0]->parent = t_node;
+      ++t_node->count;
+      parent->keys[index] = std::move(right->keys[0]);
+      for (std::size_t i = 1; i < right->count; ++i) {
+        right->keys[i - 1] = std::move(right->keys[i]);
+      }
+      for (std::size_t i = 1; i <= right->count; ++i) {
+        right->children[i - 1] = right->children[i];
+      }
+      --right->count;
+    } else if (left) {
+      merge_inners(left, t_node, index - 1);
+    } else if (right) {
+      merge_inners(t_node, right, index);
+    }
+  }
+
+  void merge_inners(inner_node* t_left, inner_node* t_right,
+                    std::size_t t_index) {
+    inner_node* parent = t_left->parent;
+    t_left->keys[t_left->count] = std::move(parent->keys[t_index]);
+    for (std::size_t i = 0; i < t_right->count; ++i) {
+      t_left->keys[t_left->count + 1 + i] = std::move(t_right->keys[i]);
+    }
+    for (std::size_t i = 0; i <= t_right->count; ++i) {
+      node* child = t_right->children[i];
+      t_left->children[t_left->count + 1 + i] = child;
+      child->parent = t_left;
+    }
+    t_left->count += 1 + t_right->count;
+    destroy_node(t_right);
+    remove_from_inner(parent, t_index);
+  }
+
+  //  целое дерево
+  void clear_btree() noexcept {
+    if (root_) destroy_subtree(root_);
+    root_ = nullptr;
+    first_ = last_ = nullptr;
+    size_ = 0;
+  }
+
+  // высота B+-дерева - единицы уровней, рекурсия здесь неглубокая
+  void destroy_subtree(node* t_node) noexcept {
+    if (t_node == nullptr) return;
+    if (!t_node->leaf) {
+      inner_node* inner = static_cast<inner_node*>(t_node);
+      for (std::size_t i = 0; i <= inner->count; ++i) {
+        destroy_subtree(inner->children[i]);
+      }
+    }
+    destroy_node(t_node);
+  }
+
+  // копия повторяет форму исходного дерева, листья сшиваются по ходу обхода
+  void copy_btree(const BTree& t_other) {
+    if (this == &t_other) return;
+    BTree copy(t_other.compare_, allocator_type(allocator_));
+    if (t_other.root_) {
+      leaf_node* last = nullptr;
+      copy.clone_subtree(t_other.root_, nullptr, copy.root_, last);
+      copy.last_ = last;
+      copy.size_ = t_other.size_;
+    }
+    swap_contents(copy);
+  }
+
+  // узел сразу вешается в t_slot, при исключении копию разберет деструктор
+  void clone_subtree(const node* t_from, inner_node* t_parent, node*& t_slot,
+                     leaf_node*& t_last) {
+    if (t_from->leaf) {
+      const leaf_node* from = static_cast<const leaf_node*>(t_from);
+      leaf_node* leaf = create_node<leaf_node>();
+      t_slot = leaf;
+      leaf->parent = t_parent;
+      leaf->prev = t_last;
+      (t_last ? t_last->next : first_) = leaf;
+      t_last = leaf;
+      for (std::size_t i = 0; i < from->count; ++i) {
+        leaf->keys[i] = from->keys[i];
+        if constexpr (!std::is_void_v<T>) {
+          leaf->values[i] = from->values[i];
+        }
+      }
+      leaf->count = from->count;
+      return;
+    }
+    const inner_node* from = static_cast<const inner_node*>(t_from);
+    inner_node* inner = create_node<inner_node>();
+    t_slot = inner;
+    inner->parent = t_parent;
+    inner->count = from->count;
+    for (std::size_t i = 0; i < from->count; ++i) {
+      inner->keys[i] = from->keys[i];
+    }
+    for (std::size_t i = 0; i <= from->count; ++i) {
+      clone_subtree(from->children[i], inner, inner->children[i], t_last);
+    }
+  }
+
+  void swap_contents(BTree& t_other) noexcept {
+    std::swap(root_, t_other.root_);
+    std::swap(first_, t_other.first_);
+    std::swap(last_, t_other.last_);
+    std::swap(size_, t_other.size_);
+    std::swap(compare_, t_other.compare_);
+  }
+
+  void swap_btree(BTree& t_other) noexcept {
+    swap_contents(t_other);
+    if constexpr (block_traits::propagate_on_container_swap::value) {
+      std::swap(allocator_, t_other.allocator_);
+    }
+  }
+
+  void move_btree(BTree& t_other) {
+    if (this == &t_other) return;
+    clear_btree();
+    if constexpr (!block_traits::propagate_on_container_move_assignment::
+                      value) {
+      if (allocator_ != t_other.allocator_) {
+        copy_btree(t_other);
+        t_other.clear_btree();
+        return;
+      }
+    } else {
+      allocator_ = t_other.allocator_;
+    }
+    swap_contents(t_other);
+  }
+
+  node* root_ = nullptr;
+  leaf_node* first_ = nullptr;
+  leaf_node* last_ = nullptr;
+  size_type size_ = 0;
+  block_allocator_type allocator_;
+  Compare compare_;
+};
+}  // namespace s21
+
+#endif  // S21_BTREE_H_
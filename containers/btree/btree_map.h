@@ -0,0 +1,197 @@
+#ifndef S21_BTREE_MAP_H_
+#define S21_BTREE_MAP_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "btree.h"
+
+namespace s21 {
+// Map on top of a B+tree: same interface, without order statistics
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = pool_allocator<std::pair<const Key, T>>>
+class btree_map : public BTree<Key, T, Compare, Allocator> {
+  using tree_type = BTree<Key, T, Compare, Allocator>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = typename tree_type::reference;
+  using iterator = typename tree_type::iterator;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+
+  //  btree_map Member functions
+  btree_map() : tree_type() {}
+
+  explicit btree_map(const Allocator& alloc) : tree_type(alloc) {}
+
+  explicit btree_map(const Compare& compare,
+                     const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {}
+
+  btree_map(std::initializer_list<value_type> const& items,
+            const Compare& compare = Compare(),
+            const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_btree(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  btree_map(InputIt first, InputIt last, const Compare& compare = Compare(),
+            const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_btree(first, last);
+  }
+
+  btree_map(const btree_map& other)
+      : tree_type(other.key_comp(),
+                  std::allocator_traits<Allocator>::
+                      select_on_container_copy_construction(
+                          other.get_allocator())) {
+    *this = other;
+  }
+
+  btree_map& operator=(const btree_map& other) {
+    this->copy_btree(other);
+    return *this;
+  }
+
+  btree_map(btree_map&& other) : tree_type(other.get_allocator()) {
+    *this = std::move(other);
+  }
+
+  btree_map& operator=(btree_map&& other) {
+    this->move_btree(other);
+    return *this;
+  }
+
+  //  element access
+  T& at(const Key& key) {
+    iterator it = find(key);
+    if (it == this->end()) {
+      throw std::out_of_range("No elements with such key");
+    }
+    return (*it).second;
+  }
+
+  T& operator[](const Key& key) { return (*try_emplace(key).first).second; }
+
+  //  modifiers
+  void erase(iterator pos) { this->erase_btree(pos); }
+
+  size_type erase(const Key& key) { return this->erase_key_btree(key); }
+
+  void clear() { this->clear_btree(); }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return this->emplace_unique_btree(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return this->emplace_unique_btree(key, obj);
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_btree(first, last);
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
+    auto inserted = this->emplace_unique_btree(key, obj);
+    if (!inserted.second) (*inserted.first).second = obj;
+    return inserted;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return this->emplace_unique_btree(key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return this->emplace_unique_btree(std::move(key),
+                                      std::forward<Args>(args)...);
+  }
+
+  template <typename K, typename M>
+  std::pair<iterator, bool> emplace(K&& key, M&& mapped) {
+    return this->emplace_unique_btree(std::forward<K>(key),
+                                      std::forward<M>(mapped));
+  }
+
+  void swap(btree_map& other) { this->swap_btree(other); }
+
+  // keys missing here move over, the rest stay in other
+  void merge(btree_map& other) { this->merge_btree(other); }
+
+  //  lookup
+  iterator find(const Key& key) const { return this->find_btree(key); }
+
+  bool contains(const Key& key) const { return find(key) != this->end(); }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    return this->lower_bound_btree(key);
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return this->upper_bound_btree(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  // a transparent Compare looks up by any comparable K, no Key is built
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return this->find_btree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return this->find_btree(key) != this->end();
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return this->lower_bound_btree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return this->upper_bound_btree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+};
+}  // namespace s21
+
+#endif  // S21_BTREE_MAP_H_
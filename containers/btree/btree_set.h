@@ -0,0 +1,167 @@
+#ifndef S21_BTREE_SET_H_
+#define S21_BTREE_SET_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "btree.h"
+
+namespace s21 {
+// Set on top of a B+tree: same interface, without order statistics
+template <typename Key, typename Compare = std::less<Key>,
+          typename Allocator = pool_allocator<Key>>
+class btree_set : public BTree<Key, void, Compare, Allocator> {
+  using tree_type = BTree<Key, void, Compare, Allocator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::iterator;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+
+  //  btree_set Member functions
+  btree_set() : tree_type() {}
+
+  explicit btree_set(const Allocator& alloc) : tree_type(alloc) {}
+
+  explicit btree_set(const Compare& compare,
+                     const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {}
+
+  btree_set(std::initializer_list<Key> const& items,
+            const Compare& compare = Compare(),
+            const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_btree(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  btree_set(InputIt first, InputIt last, const Compare& compare = Compare(),
+            const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_btree(first, last);
+  }
+
+  btree_set(const btree_set& other)
+      : tree_type(other.key_comp(),
+                  std::allocator_traits<Allocator>::
+                      select_on_container_copy_construction(
+                          other.get_allocator())) {
+    *this = other;
+  }
+
+  btree_set& operator=(const btree_set& other) {
+    this->copy_btree(other);
+    return *this;
+  }
+
+  btree_set(btree_set&& other) : tree_type(other.get_allocator()) {
+    *this = std::move(other);
+  }
+
+  btree_set& operator=(btree_set&& other) {
+    this->move_btree(other);
+    return *this;
+  }
+
+  //  modifiers
+  void erase(iterator pos) { this->erase_btree(pos); }
+
+  size_type erase(const Key& key) { return this->erase_key_btree(key); }
+
+  void clear() { this->clear_btree(); }
+
+  std::pair<iterator, bool> insert(const Key& value) {
+    return this->emplace_unique_btree(value);
+  }
+
+  std::pair<iterator, bool> insert(Key&& value) {
+    return this->emplace_unique_btree(std::move(value));
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_btree(first, last);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return this->emplace_unique_btree(Key(std::forward<Args>(args)...));
+  }
+
+  void swap(btree_set& other) { this->swap_btree(other); }
+
+  // keys missing here move over, the rest stay in other
+  void merge(btree_set& other) { this->merge_btree(other); }
+
+  //  lookup
+  iterator find(const Key& key) const { return this->find_btree(key); }
+
+  bool contains(const Key& key) const { return find(key) != this->end(); }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    return this->lower_bound_btree(key);
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return this->upper_bound_btree(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  // a transparent Compare looks up by any comparable K, no Key is built
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return this->find_btree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return this->find_btree(key) != this->end();
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return this->lower_bound_btree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return this->upper_bound_btree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+};
+}  // namespace s21
+
+#endif  // S21_BTREE_SET_H_
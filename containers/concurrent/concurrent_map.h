@@ -0,0 +1,218 @@
+#ifndef S21_CONCURRENT_MAP_H_
+#define S21_CONCURRENT_MAP_H_
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+#include "../set-map/map.h"
+#include "../utils/defines.h"
+
+namespace s21 {
+/*
+ * Потокобезопасный словарь из Shards независимых Map. Ключ попадает в шард
+ * по хешу, у каждого шарда свой shared_mutex: чтения одного шарда идут
+ * параллельно, записи в разные шарды не мешают друг другу. Ссылки наружу
+ * не отдаются - find возвращает копию значения, доступ на месте идет через
+ * visit. Обход по порядку ключей берет разделяемые блокировки всех шардов
+ * (всегда в порядке номеров) и сливает их отсортированные обходы.
+ */
+template <typename Key, typename T,
+          std::size_t Shards = defines::CONCURRENT_SHARDS,
+          typename Compare = std::less<Key>, typename Hash = std::hash<Key>>
+class concurrent_map {
+  static_assert(Shards > 0, "concurrent_map needs at least one shard");
+
+  using shard_map = Map<Key, T, Compare>;
+
+  // свой кэш-лайн на шард, чтобы мьютексы соседей не делили строку
+  struct alignas(64) shard {
+    mutable std::shared_mutex mutex;
+    shard_map map;
+  };
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+  using hasher = Hash;
+
+  concurrent_map() = default;
+
+  explicit concurrent_map(const Compare& compare, const Hash& hash = Hash())
+      : hash_(hash), compare_(compare) {
+    for (shard& part : shards_) {
+      part.map = shard_map(compare);
+    }
+  }
+
+  concurrent_map(const concurrent_map&) = delete;
+  concurrent_map& operator=(const concurrent_map&) = delete;
+
+  static constexpr size_type shard_count() noexcept { return Shards; }
+
+  //  lookup
+  std::optional<T> find(const Key& key) const {
+    const shard& part = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(part.mutex);
+    auto it = part.map.find(key);
+    if (it == part.map.end()) return std::nullopt;
+    return (*it).second;
+  }
+
+  bool contains(const Key& key) const {
+    const shard& part = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(part.mutex);
+    return part.map.contains(key);
+  }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  // fn(const T&) under the shard's shared lock; false when key is absent
+  template <typename Fn>
+  bool cvisit(const Key& key, Fn&& fn) const {
+    const shard& part = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(part.mutex);
+    auto it = part.map.find(key);
+    if (it == part.map.end()) return false;
+    std::forward<Fn>(fn)(static_cast<const T&>((*it).second));
+    return true;
+  }
+
+  // fn(T&) under the shard's exclusive lock; false when key is absent
+  template <typename Fn>
+  bool visit(const Key& key, Fn&& fn) {
+    shard& part = shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(part.mutex);
+    auto it = part.map.find(key);
+    if (it == part.map.end()) return false;
+    std::forward<Fn>(fn)((*it).second);
+    return true;
+  }
+
+  //  modifiers
+  bool insert(const Key& key, const T& obj) {
+    shard& part = shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(part.mutex);
+    return part.map.insert(key, obj).second;
+  }
+
+  // true when the key was new
+  bool insert_or_assign(const Key& key, const T& obj) {
+    shard& part = shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(part.mutex);
+    return part.map.insert_or_assign(key, obj).second;
+  }
+
+  size_type erase(const Key& key) {
+    shard& part = shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(part.mutex);
+    auto it = part.map.find(key);
+    if (it == part.map.end()) return 0;
+    part.map.erase(it);
+    return 1;
+  }
+
+  void clear() {
+    for (shard& part : shards_) {
+      std::unique_lock<std::shared_mutex> lock(part.mutex);
+      part.map.clear();
+    }
+  }
+
+  //  capacity
+  // a consistent snapshot: every shard is held while counting
+  size_type size() const {
+    auto locks = lock_all();
+    size_type total = 0;
+    for (const shard& part : shards_) total += part.map.size();
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  //  ordered scans
+  // fn(const Key&, const T&) for every key in [lo, hi), in key order
+  template <typename Fn>
+  void scan(const Key& lo, const Key& hi, Fn&& fn) const {
+    auto locks = lock_all();
+    merge_walk(
+        [&lo](const shard_map& map) { return map.lower_bound(lo); },
+        [this, &hi](const Key& key) { return compare_(key, hi); }, fn);
+  }
+
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    auto locks = lock_all();
+    merge_walk([](const shard_map& map) { return map.begin(); },
+               [](const Key&) { return true; }, fn);
+  }
+
+ private:
+  using iterator = typename shard_map::iterator;
+
+  size_type index_for(const Key& key) const {
+    // std::hash целых - тождественная функция, старшие биты после умножения
+    // распределяют подряд идущие ключи равномернее
+    std::size_t hash = hash_(key) * static_cast<std::size_t>(
+                                        0x9E3779B97F4A7C15ULL);
+    return (hash >> (sizeof(std::size_t) * 4)) % Shards;
+  }
+
+  shard& shard_for(const Key& key) { return shards_[index_for(key)]; }
+
+  const shard& shard_for(const Key& key) const {
+    return shards_[index_for(key)];
+  }
+
+  // порядок захвата фиксирован, поэтому два обхода не заблокируют друг друга
+  struct all_locks {
+    std::shared_lock<std::shared_mutex> locks[Shards];
+  };
+
+  all_locks lock_all() const {
+    all_locks held;
+    for (std::size_t i = 0; i < Shards; ++i) {
+      held.locks[i] = std::shared_lock<std::shared_mutex>(shards_[i].mutex);
+    }
+    return held;
+  }
+
+  /*
+   * слияние Shards отсортированных обходов: на каждом шаге выбирается
+   * наименьший текущий ключ; шардов немного, линейный выбор дешевле кучи
+   */
+  template <typename Start, typename Within, typename Fn>
+  void merge_walk(Start start, Within within, Fn& fn) const {
+    iterator cursors[Shards];
+    for (std::size_t i = 0; i < Shards; ++i) {
+      cursors[i] = start(shards_[i].map);
+    }
+    while (true) {
+      std::size_t best = Shards;
+      for (std::size_t i = 0; i < Shards; ++i) {
+        if (cursors[i] == shards_[i].map.end()) continue;
+        if (best == Shards ||
+            compare_((*cursors[i]).first, (*cursors[best]).first)) {
+          best = i;
+        }
+      }
+      if (best == Shards || !within((*cursors[best]).first)) return;
+      const auto& values = *cursors[best];
+      fn(static_cast<const Key&>(values.first),
+         static_cast<const T&>(values.second));
+      ++cursors[best];
+    }
+  }
+
+  shard shards_[Shards];
+  Hash hash_;
+  Compare compare_;
+};
+}  // namespace s21
+
+#endif  // S21_CONCURRENT_MAP_H_
@@ -0,0 +1,213 @@
+#ifndef S21_FLAT_MAP_H_
+#define S21_FLAT_MAP_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "flat_tree.h"
+
+namespace s21 {
+// Map over sorted vectors: keys and values are stored apart
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map : public FlatTree<Key, T, Compare> {
+  using tree_type = FlatTree<Key, T, Compare>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = typename tree_type::reference;
+  using iterator = typename tree_type::iterator;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using key_container_type = vector<Key>;
+  using mapped_container_type = vector<T>;
+
+  // what extract() hands out and replace() takes back
+  struct containers {
+    key_container_type keys;
+    mapped_container_type values;
+  };
+
+  //  flat_map Member functions
+  flat_map() : tree_type() {}
+
+  explicit flat_map(const Compare& compare) : tree_type(compare) {}
+
+  flat_map(std::initializer_list<value_type> const& items,
+           const Compare& compare = Compare())
+      : tree_type(compare) {
+    this->insert_range_flat(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  flat_map(InputIt first, InputIt last, const Compare& compare = Compare())
+      : tree_type(compare) {
+    this->insert_range_flat(first, last);
+  }
+
+  //  element access
+  T& at(const Key& key) {
+    iterator it = find(key);
+    if (it == this->end()) {
+      throw std::out_of_range("No elements with such key");
+    }
+    return (*it).second;
+  }
+
+  T& operator[](const Key& key) { return (*try_emplace(key).first).second; }
+
+  //  modifiers
+  void erase(iterator pos) { this->erase_at(this->index_of(pos)); }
+
+  size_type erase(const Key& key) { return this->erase_key_flat(key); }
+
+  void clear() { this->clear_flat(); }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return this->emplace_unique_flat(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return this->emplace_unique_flat(key, obj);
+  }
+
+  // sorts the new elements once and merges them in: O(n + m log m)
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_flat(first, last);
+  }
+
+  void insert(std::initializer_list<value_type> const& items) {
+    this->insert_range_flat(items.begin(), items.end());
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
+    auto inserted = this->emplace_unique_flat(key, obj);
+    if (!inserted.second) (*inserted.first).second = obj;
+    return inserted;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return this->emplace_unique_flat(key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return this->emplace_unique_flat(std::move(key),
+                                     std::forward<Args>(args)...);
+  }
+
+  template <typename K, typename M>
+  std::pair<iterator, bool> emplace(K&& key, M&& mapped) {
+    return this->emplace_unique_flat(std::forward<K>(key),
+                                     std::forward<M>(mapped));
+  }
+
+  void swap(flat_map& other) { this->swap_flat(other); }
+
+  // keys missing here move over, the rest stay in other; O(n + m)
+  void merge(flat_map& other) { this->merge_flat(other); }
+
+  // hands out both vectors and leaves the map empty
+  containers extract() {
+    return containers{std::move(this->keys_), std::move(this->values_)};
+  }
+
+  // keys must already be sorted by Compare and unique
+  void replace(key_container_type&& keys, mapped_container_type&& values) {
+    if (keys.size() != values.size()) {
+      throw std::invalid_argument("keys and values differ in size");
+    }
+    this->keys_ = std::move(keys);
+    this->values_ = std::move(values);
+  }
+
+  const key_container_type& keys() const noexcept { return this->keys_; }
+
+  const mapped_container_type& values() const noexcept {
+    return this->values_;
+  }
+
+  //  lookup
+  iterator find(const Key& key) const {
+    return iterator(this, this->find_index(key));
+  }
+
+  bool contains(const Key& key) const { return find(key) != this->end(); }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    return iterator(this, this->lower_index(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return iterator(this, this->upper_index(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  // a transparent Compare looks up by any comparable K, no Key is built
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return iterator(this, this->find_index(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return this->find_index(key) != this->size();
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return iterator(this, this->lower_index(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return iterator(this, this->upper_index(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  //  order statistics, O(1) and O(log n) on a sorted array
+  iterator nth(size_type k) const noexcept {
+    return iterator(this, k < this->size() ? k : this->size());
+  }
+
+  size_type rank(const Key& key) const { return this->find_index(key); }
+
+  size_type count_less(const Key& key) const {
+    return this->lower_index(key);
+  }
+};
+}  // namespace s21
+
+#endif  // S21_FLAT_MAP_H_
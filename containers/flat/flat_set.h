@@ -0,0 +1,164 @@
+#ifndef S21_FLAT_SET_H_
+#define S21_FLAT_SET_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "flat_tree.h"
+
+namespace s21 {
+// Set over one sorted vector of keys
+template <typename Key, typename Compare = std::less<Key>>
+class flat_set : public FlatTree<Key, void, Compare> {
+  using tree_type = FlatTree<Key, void, Compare>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::iterator;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using container_type = vector<Key>;
+
+  //  flat_set Member functions
+  flat_set() : tree_type() {}
+
+  explicit flat_set(const Compare& compare) : tree_type(compare) {}
+
+  flat_set(std::initializer_list<Key> const& items,
+           const Compare& compare = Compare())
+      : tree_type(compare) {
+    this->insert_range_flat(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  flat_set(InputIt first, InputIt last, const Compare& compare = Compare())
+      : tree_type(compare) {
+    this->insert_range_flat(first, last);
+  }
+
+  //  modifiers
+  void erase(iterator pos) { this->erase_at(this->index_of(pos)); }
+
+  size_type erase(const Key& key) { return this->erase_key_flat(key); }
+
+  void clear() { this->clear_flat(); }
+
+  std::pair<iterator, bool> insert(const Key& value) {
+    return this->emplace_unique_flat(value);
+  }
+
+  std::pair<iterator, bool> insert(Key&& value) {
+    return this->emplace_unique_flat(std::move(value));
+  }
+
+  // sorts the new keys once and merges them in: O(n + m log m)
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_flat(first, last);
+  }
+
+  void insert(std::initializer_list<Key> const& items) {
+    this->insert_range_flat(items.begin(), items.end());
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return this->emplace_unique_flat(Key(std::forward<Args>(args)...));
+  }
+
+  void swap(flat_set& other) { this->swap_flat(other); }
+
+  // keys missing here move over, the rest stay in other; O(n + m)
+  void merge(flat_set& other) { this->merge_flat(other); }
+
+  // hands out the key vector and leaves the set empty
+  container_type extract() { return std::move(this->keys_); }
+
+  // keys must already be sorted by Compare and unique
+  void replace(container_type&& keys) { this->keys_ = std::move(keys); }
+
+  const container_type& keys() const noexcept { return this->keys_; }
+
+  //  lookup
+  iterator find(const Key& key) const {
+    return iterator(this, this->find_index(key));
+  }
+
+  bool contains(const Key& key) const { return find(key) != this->end(); }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    return iterator(this, this->lower_index(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return iterator(this, this->upper_index(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  // a transparent Compare looks up by any comparable K, no Key is built
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return iterator(this, this->find_index(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return this->find_index(key) != this->size();
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return iterator(this, this->lower_index(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return iterator(this, this->upper_index(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  //  order statistics, O(1) and O(log n) on a sorted array
+  iterator nth(size_type k) const noexcept {
+    return iterator(this, k < this->size() ? k : this->size());
+  }
+
+  size_type rank(const Key& key) const { return this->find_index(key); }
+
+  size_type count_less(const Key& key) const {
+    return this->lower_index(key);
+  }
+};
+}  // namespace s21
+
+#endif  // S21_FLAT_SET_H_
@@ -0,0 +1,327 @@
+#ifndef S21_FLAT_TREE_H_
+#define S21_FLAT_TREE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "../utils/defines.h"
+#include "../vector/vector.h"
+
+namespace s21 {
+// отображаемые значения лежат в своем векторе, у множеств его нет
+template <typename T>
+struct flat_values_ {
+  vector<T> values_ = vector<T>(0);
+};
+
+template <>
+struct flat_values_<void> {};
+
+/*
+ * Упорядоченный контейнер поверх двух s21::vector: отсортированные
+ * уникальные ключи и параллельный им вектор значений (для T = void - только
+ * ключи). Поиск - двоичный по непрерывному массиву, вставка и удаление
+ * одного элемента сдвигают хвост за O(n), пакетная вставка сортирует новые
+ * элементы и сливает их с уже имеющимися за один проход. Любое изменение
+ * инвалидирует итераторы.
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class FlatTree : protected flat_values_<T> {
+ public:
+  using key_type = Key;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+  using reference =
+      std::conditional_t<std::is_void_v<T>, const Key&,
+                         std::pair<const Key&, std::add_lvalue_reference_t<
+                                                   std::conditional_t<
+                                                       std::is_void_v<T>, int,
+                                                       T>>>>;
+
+  class iterator {
+   public:
+    using reference = typename FlatTree::reference;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+    using pointer = void;
+
+    // для operator-> у пар из ссылок
+    struct arrow_proxy {
+      reference ref;
+      std::remove_reference_t<reference>* operator->() noexcept {
+        return std::addressof(ref);
+      }
+    };
+
+    iterator() = default;
+    iterator(const FlatTree* t_tree, std::size_t t_index)
+        : tree_(t_tree), index_(t_index) {}
+
+    reference operator*() const { return tree_->element(index_); }
+
+    arrow_proxy operator->() const { return arrow_proxy{**this}; }
+
+    iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    bool operator==(const iterator& t_other) const noexcept {
+      return index_ == t_other.index_;
+    }
+
+    bool operator!=(const iterator& t_other) const noexcept {
+      return !(*this == t_other);
+    }
+
+   private:
+    friend class FlatTree;
+
+    const FlatTree* tree_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+ public:
+  FlatTree() : FlatTree(Compare()) {}
+
+  explicit FlatTree(const Compare& t_compare)
+      : keys_(0), compare_(t_compare) {}
+
+  key_compare key_comp() const { return compare_; }
+
+  bool empty() const noexcept { return keys_.size() == 0; }
+
+  size_type size() const noexcept { return keys_.size(); }
+
+  size_type max_size() const noexcept { return keys_.max_size(); }
+
+  iterator begin() const noexcept { return iterator(this, 0); }
+
+  iterator end() const noexcept { return iterator(this, keys_.size()); }
+
+ protected:
+  static std::size_t index_of(iterator t_pos) noexcept { return t_pos.index_; }
+
+  reference element(std::size_t t_index) const {
+    Key* keys = const_cast<Key*>(keys_.data());
+    if constexpr (std::is_void_v<T>) {
+      return keys[t_index];
+    } else {
+      T* values = const_cast<T*>(this->values_.data());
+      return reference(keys[t_index], values[t_index]);
+    }
+  }
+
+  //  поиск
+  /*
+   * двоичный поиск без ветвлений: шаг выбирает половину условным
+   * присваиванием, число итераций зависит только от размера
+   */
+  template <typename K>
+  std::size_t lower_index(const K& t_key) const {
+    const Key* base = keys_.data();
+    std::size_t n = keys_.size();
+    if (n == 0) return 0;
+    while (n > 1) {
+      std::size_t half = n / 2;
+      base = compare_(base[half], t_key) ? base + half : base;
+      n -= half;
+    }
+    return static_cast<std::size_t>(base - keys_.data()) +
+           compare_(*base, t_key);
+  }
+
+  template <typename K>
+  std::size_t upper_index(const K& t_key) const {
+    const Key* base = keys_.data();
+    std::size_t n = keys_.size();
+    if (n == 0) return 0;
+    while (n > 1) {
+      std::size_t half = n / 2;
+      base = compare_(t_key, base[half]) ? base : base + half;
+      n -= half;
+    }
+    return static_cast<std::size_t>(base - keys_.data()) +
+           !compare_(t_key, *base);
+  }
+
+  template <typename K>
+  std::size_t find_index(const K& t_key) const {
+    std::size_t index = lower_index(t_key);
+    if (index < keys_.size() && !compare_(t_key, keys_.data()[index])) {
+      return index;
+    }
+    return keys_.size();
+  }
+
+  //  вставка и удаление
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> emplace_unique_flat(K&& t_key, Args&&... t_args) {
+    std::size_t index = lower_index(t_key);
+    if (index < keys_.size() && !compare_(t_key, keys_.data()[index])) {
+      return std::make_pair(iterator(this, index), false);
+    }
+    insert_at(index, Key(std::forward<K>(t_key)), std::forward<Args>(t_args)...);
+    return std::make_pair(iterator(this, index), true);
+  }
+
+  template <typename... Args>
+  void insert_at(std::size_t t_index, Key t_key, Args&&... t_args) {
+    if constexpr (std::is_void_v<T>) {
+      keys_.insert(keys_.cbegin() + t_index, std::move(t_key));
+    } else {
+      T mapped(std::forward<Args>(t_args)...);
+      keys_.insert(keys_.cbegin() + t_index, std::move(t_key));
+      try {
+        this->values_.insert(this->values_.cbegin() + t_index,
+                             std::move(mapped));
+      } catch (...) {
+        keys_.erase(keys_.begin() + t_index);
+        THROW_FURTHER;
+      }
+    }
+  }
+
+  void erase_at(std::size_t t_index) {
+    keys_.erase(keys_.begin() + t_index);
+    if constexpr (!std::is_void_v<T>) {
+      this->values_.erase(this->values_.begin() + t_index);
+    }
+  }
+
+  template <typename K>
+  size_type erase_key_flat(const K& t_key) {
+    std::size_t index = find_index(t_key);
+    if (index == keys_.size()) return 0;
+    erase_at(index);
+    return 1;
+  }
+
+  /*
+   * пакетная вставка: новые элементы сортируются отдельно, из равных
+   * остается первый, затем один проход слияния; O(n + m log m)
+   */
+  template <typename InputIt>
+  void insert_range_flat(InputIt t_first, InputIt t_last) {
+    using staged_type =
+        std::conditional_t<std::is_void_v<T>, Key, std::pair<Key, T>>;
+    vector<staged_type> staged(0);
+    for (; t_first != t_last; ++t_first) {
+      staged.emplace_back(*t_first);
+    }
+    staged_type* first = staged.data();
+    staged_type* last = first + staged.size();
+    std::stable_sort(first, last,
+                     [this](const staged_type& a, const staged_type& b) {
+                       return compare_(key_of(a), key_of(b));
+                     });
+
+    FlatTree incoming(compare_);
+    incoming.reserve_flat(staged.size());
+    for (staged_type* it = first; it != last; ++it) {
+      if (!incoming.empty() &&
+          !compare_(incoming.keys_.data()[incoming.size() - 1], key_of(*it))) {
+        continue;
+      }
+      if constexpr (std::is_void_v<T>) {
+        incoming.append(std::move(*it));
+      } else {
+        incoming.append(std::move(it->first), std::move(it->second));
+      }
+    }
+    merge_flat(incoming);
+  }
+
+  static const Key& key_of(const Key& t_key) noexcept { return t_key; }
+
+  template <typename P>
+  static const Key& key_of(const P& t_pair) noexcept {
+    return t_pair.first;
+  }
+
+  /*
+   * слияние двух отсортированных массивов: недостающие ключи переезжают
+   * сюда, равные остаются в t_other; O(n + m)
+   */
+  void merge_flat(FlatTree& t_other) {
+    if (this == &t_other || t_other.empty()) return;
+    FlatTree merged(compare_);
+    FlatTree rest(t_other.compare_);
+    merged.reserve_flat(size() + t_other.size());
+    std::size_t i = 0;
+    std::size_t j = 0;
+    const Key* ours = keys_.data();
+    const Key* theirs = t_other.keys_.data();
+    while (i < size() || j < t_other.size()) {
+      if (j == t_other.size() ||
+          (i < size() && compare_(ours[i], theirs[j]))) {
+        merged.take(*this, i++);
+      } else if (i == size() || compare_(theirs[j], ours[i])) {
+        merged.take(t_other, j++);
+      } else {
+        merged.take(*this, i++);
+        rest.take(t_other, j++);
+      }
+    }
+    swap_flat(merged);
+    t_other.swap_flat(rest);
+  }
+
+  // переносит элемент t_index из t_from в конец; порядок не проверяется
+  void take(FlatTree& t_from, std::size_t t_index) {
+    if constexpr (std::is_void_v<T>) {
+      append(std::move_if_noexcept(t_from.keys_.data()[t_index]));
+    } else {
+      append(std::move_if_noexcept(t_from.keys_.data()[t_index]),
+             std::move_if_noexcept(t_from.values_.data()[t_index]));
+    }
+  }
+
+  template <typename K, typename... M>
+  void append(K&& t_key, M&&... t_mapped) {
+    keys_.push_back(std::forward<K>(t_key));
+    if constexpr (!std::is_void_v<T>) {
+      this->values_.push_back(std::forward<M>(t_mapped)...);
+    }
+  }
+
+  void reserve_flat(std::size_t t_size) {
+    if (t_size <= keys_.capacity()) return;
+    keys_.reserve(t_size);
+    if constexpr (!std::is_void_v<T>) {
+      this->values_.reserve(t_size);
+    }
+  }
+
+  void clear_flat() noexcept {
+    keys_.clear();
+    if constexpr (!std::is_void_v<T>) {
+      this->values_.clear();
+    }
+  }
+
+  void swap_flat(FlatTree& t_other) noexcept {
+    keys_.swap(t_other.keys_);
+    if constexpr (!std::is_void_v<T>) {
+      this->values_.swap(t_other.values_);
+    }
+    std::swap(compare_, t_other.compare_);
+  }
+
+  vector<Key> keys_;
+  Compare compare_;
+};
+}  // namespace s21
+
+#endif  // S21_FLAT_TREE_H_
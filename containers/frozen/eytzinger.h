@@ -0,0 +1,364 @@
+#ifndef S21_EYTZINGER_H_
+#define S21_EYTZINGER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "../utils/defines.h"
+#include "../vector/vector.h"
+
+namespace s21 {
+// вход уже отсортирован и без повторов: сортировка при сборке не нужна
+struct sorted_unique_t {
+  explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+// отображаемые значения лежат в своем векторе в том же порядке, что ключи
+template <typename T>
+struct eytzinger_values_ {
+  vector<T> values_ = vector<T>(0);
+};
+
+template <>
+struct eytzinger_values_<void> {};
+
+/*
+ * Неизменяемый упорядоченный контейнер: ключи лежат в одном массиве в
+ * порядке обхода в ширину неявного дерева (Эйтцингер), потомки узла k -
+ * 2k и 2k + 1 при нумерации с единицы. Спуск идет без ветвлений: номер
+ * следующего узла вычисляется из результата сравнения, а потомки на
+ * несколько уровней вперед лежат в одной кэш-линии и подгружаются заранее.
+ * Итератор хранит номер узла, ++ переходит к следующему по порядку узлу
+ * неявного дерева за амортизированное O(1); 0 означает end()
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class Eytzinger : protected eytzinger_values_<T> {
+ public:
+  using key_type = Key;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+  using reference = std::conditional_t<
+      std::is_void_v<T>, const Key&,
+      std::pair<const Key&,
+                const std::conditional_t<std::is_void_v<T>, int, T>&>>;
+
+  class iterator {
+   public:
+    using reference = typename Eytzinger::reference;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+    using pointer = void;
+
+    // для operator-> у пар из ссылок
+    struct arrow_proxy {
+      reference ref;
+      std::remove_reference_t<reference>* operator->() noexcept {
+        return std::addressof(ref);
+      }
+    };
+
+    iterator() = default;
+    iterator(const Eytzinger* t_tree, std::size_t t_index)
+        : tree_(t_tree), index_(t_index) {}
+
+    reference operator*() const { return tree_->element(index_); }
+
+    arrow_proxy operator->() const { return arrow_proxy{**this}; }
+
+    iterator& operator++() noexcept {
+      index_ = next_index(index_, tree_->size());
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    iterator& operator--() noexcept {
+      index_ = index_ ? prev_index(index_, tree_->size())
+                      : last_index(tree_->size());
+      return *this;
+    }
+
+    iterator operator--(int) noexcept {
+      iterator copy = *this;
+      --*this;
+      return copy;
+    }
+
+    bool operator==(const iterator& t_other) const noexcept {
+      return index_ == t_other.index_;
+    }
+
+    bool operator!=(const iterator& t_other) const noexcept {
+      return !(*this == t_other);
+    }
+
+   private:
+    friend class Eytzinger;
+
+    const Eytzinger* tree_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+  Eytzinger() : Eytzinger(Compare()) {}
+
+  explicit Eytzinger(const Compare& t_compare)
+      : keys_(0), compare_(t_compare) {}
+
+  key_compare key_comp() const { return compare_; }
+
+  bool empty() const noexcept { return keys_.size() == 0; }
+
+  size_type size() const noexcept { return keys_.size(); }
+
+  iterator begin() const noexcept {
+    return iterator(this, first_index(keys_.size()));
+  }
+
+  iterator end() const noexcept { return iterator(this, 0); }
+
+ protected:
+  static std::size_t index_of(iterator t_pos) noexcept { return t_pos.index_; }
+
+  reference element(std::size_t t_index) const {
+    const Key& key = keys_.data()[t_index - 1];
+    if constexpr (std::is_void_v<T>) {
+      return key;
+    } else {
+      return reference(key, this->values_.data()[t_index - 1]);
+    }
+  }
+
+  //  навигация по неявному дереву из t_size узлов
+  static std::size_t first_index(std::size_t t_size) noexcept {
+    std::size_t index = t_size ? 1 : 0;
+    while (index && 2 * index <= t_size) index *= 2;
+    return index;
+  }
+
+  static std::size_t last_index(std::size_t t_size) noexcept {
+    std::size_t index = t_size ? 1 : 0;
+    while (index && 2 * index + 1 <= t_size) index = 2 * index + 1;
+    return index;
+  }
+
+  static std::size_t next_index(std::size_t t_index,
+                                std::size_t t_size) noexcept {
+    if (2 * t_index + 1 <= t_size) {
+      t_index = 2 * t_index + 1;
+      while (2 * t_index <= t_size) t_index *= 2;
+      return t_index;
+    }
+    // подъем, пока узел - правый потомок; корень дает 0, то есть end()
+    while (t_index & 1) t_index >>= 1;
+    return t_index >> 1;
+  }
+
+  static std::size_t prev_index(std::size_t t_index,
+                                std::size_t t_size) noexcept {
+    if (2 * t_index <= t_size) {
+      t_index = 2 * t_index;
+      while (2 * t_index + 1 <= t_size) t_index = 2 * t_index + 1;
+      return t_index;
+    }
+    while (t_index && !(t_index & 1)) t_index >>= 1;
+    return t_index >> 1;
+  }
+
+  /*
+   * спуск кодирует путь битами номера: 1 - поворот направо. Ответ - узел,
+   * где был последний поворот налево, поэтому снимаются хвостовые единицы
+   * и еще один бит
+   */
+  static std::size_t resolve(std::size_t t_index) noexcept {
+#if defined(__GNUC__)
+    return t_index >> (__builtin_ctzll(~static_cast<unsigned long long>(
+                           t_index)) + 1);
+#else
+    while (t_index & 1) t_index >>= 1;
+    return t_index >> 1;
+#endif
+  }
+
+  // первый из kPrefetchSpan потомков на log2(kPrefetchSpan) уровней ниже;
+  // за концом массива подсказка просто ничего не загрузит
+  void prefetch_below(std::size_t t_index) const noexcept {
+    S21_PREFETCH(reinterpret_cast<const char*>(keys_.data()) +
+                 (t_index * kPrefetchSpan - 1) * sizeof(Key));
+  }
+
+  //  поиск
+  template <typename K>
+  std::size_t lower_index(const K& t_key) const {
+    const Key* keys = keys_.data();
+    const std::size_t n = keys_.size();
+    std::size_t index = 1;
+    while (index <= n) {
+      prefetch_below(index);
+      index = 2 * index +
+              static_cast<std::size_t>(compare_(keys[index - 1], t_key));
+    }
+    return resolve(index);
+  }
+
+  template <typename K>
+  std::size_t upper_index(const K& t_key) const {
+    const Key* keys = keys_.data();
+    const std::size_t n = keys_.size();
+    std::size_t index = 1;
+    while (index <= n) {
+      prefetch_below(index);
+      index = 2 * index +
+              static_cast<std::size_t>(!compare_(t_key, keys[index - 1]));
+    }
+    return resolve(index);
+  }
+
+  template <typename K>
+  std::size_t find_index(const K& t_key) const {
+    std::size_t index = lower_index(t_key);
+    return index && !compare_(t_key, keys_.data()[index - 1]) ? index : 0;
+  }
+
+  /*
+   * Пакетный lower_index: до BATCH_LOOKUP_WIDTH независимых спусков идут
+   * по уровням вместе, так промахи кэша разных ключей перекрываются.
+   * Число шагов у всех одно - битовая длина размера; спуск, ушедший за
+   * массив раньше, дописывает единицы, которые resolve потом снимет.
+   * t_emit(искомый ключ, найденный узел) зовется в порядке запросов
+   */
+  template <typename ForwardIt, typename Emit>
+  void lower_index_batch(ForwardIt t_first, ForwardIt t_last,
+                         Emit&& t_emit) const {
+    const Key* keys = keys_.data();
+    const std::size_t n = keys_.size();
+    std::size_t levels = 0;
+    for (std::size_t rest = n; rest; rest >>= 1) ++levels;
+
+    while (t_first != t_last) {
+      ForwardIt queries[defines::BATCH_LOOKUP_WIDTH];
+      std::size_t index[defines::BATCH_LOOKUP_WIDTH];
+      std::size_t width = 0;
+      for (; width < defines::BATCH_LOOKUP_WIDTH && t_first != t_last;
+           ++t_first) {
+        queries[width] = t_first;
+        index[width++] = 1;
+      }
+      for (std::size_t level = 0; level < levels; ++level) {
+        for (std::size_t q = 0; q < width; ++q) {
+          const bool inside = index[q] <= n;
+          const std::size_t probe = inside ? index[q] : 1;
+          prefetch_below(probe);
+          const bool right = !inside || compare_(keys[probe - 1], *queries[q]);
+          index[q] = 2 * index[q] + static_cast<std::size_t>(right);
+        }
+      }
+      for (std::size_t q = 0; q < width; ++q) {
+        t_emit(*queries[q], resolve(index[q]));
+      }
+    }
+  }
+
+  //  сборка
+  /*
+   * t_first..t_last отсортированы и без повторов. Номера узлов в
+   * порядке обхода задают, на какое место встает i-й по порядку элемент
+   */
+  template <typename InputIt>
+  void build_sorted(InputIt t_first, InputIt t_last) {
+    using staged_type =
+        std::conditional_t<std::is_void_v<T>, Key, std::pair<Key, T>>;
+    vector<staged_type> staged(0);
+    for (; t_first != t_last; ++t_first) staged.emplace_back(*t_first);
+    place(staged);
+  }
+
+  template <typename InputIt>
+  void build_any(InputIt t_first, InputIt t_last) {
+    using staged_type =
+        std::conditional_t<std::is_void_v<T>, Key, std::pair<Key, T>>;
+    vector<staged_type> staged(0);
+    for (; t_first != t_last; ++t_first) staged.emplace_back(*t_first);
+    staged_type* first = staged.data();
+    staged_type* last = first + staged.size();
+    std::stable_sort(first, last,
+                     [this](const staged_type& a, const staged_type& b) {
+                       return compare_(key_of(a), key_of(b));
+                     });
+    // из равных ключей остается первый
+    vector<staged_type> unique(0);
+    unique.reserve(staged.size());
+    for (staged_type* it = first; it != last; ++it) {
+      if (unique.size() &&
+          !compare_(key_of(unique.data()[unique.size() - 1]), key_of(*it))) {
+        continue;
+      }
+      unique.emplace_back(std::move(*it));
+    }
+    place(unique);
+  }
+
+  void swap_eytzinger(Eytzinger& t_other) {
+    keys_.swap(t_other.keys_);
+    if constexpr (!std::is_void_v<T>) this->values_.swap(t_other.values_);
+    std::swap(compare_, t_other.compare_);
+  }
+
+ private:
+  static constexpr std::size_t kPrefetchSpan =
+      sizeof(Key) >= 64 ? 1 : 64 / sizeof(Key);
+
+  static const Key& key_of(const Key& t_key) noexcept { return t_key; }
+
+  template <typename P>
+  static const Key& key_of(const P& t_pair) noexcept {
+    return t_pair.first;
+  }
+
+  template <typename Staged>
+  void place(vector<Staged>& t_sorted) {
+    const std::size_t n = t_sorted.size();
+    vector<std::size_t> order(0);
+    order.reserve(n);
+    for (std::size_t k = 0; k < n; ++k) order.emplace_back(0);
+    std::size_t rank = 0;
+    for (std::size_t k = first_index(n); k; k = next_index(k, n)) {
+      order.data()[k - 1] = rank++;
+    }
+
+    vector<Key> keys(0);
+    keys.reserve(n);
+    if constexpr (std::is_void_v<T>) {
+      for (std::size_t k = 0; k < n; ++k) {
+        keys.emplace_back(std::move(t_sorted.data()[order.data()[k]]));
+      }
+    } else {
+      vector<T> values(0);
+      values.reserve(n);
+      for (std::size_t k = 0; k < n; ++k) {
+        Staged& item = t_sorted.data()[order.data()[k]];
+        keys.emplace_back(std::move(item.first));
+        values.emplace_back(std::move(item.second));
+      }
+      this->values_.swap(values);
+    }
+    keys_.swap(keys);
+  }
+
+ protected:
+  vector<Key> keys_;
+  Compare compare_;
+};
+}  // namespace s21
+
+#endif  // S21_EYTZINGER_H_
@@ -0,0 +1,137 @@
+#ifndef S21_FROZEN_MAP_H_
+#define S21_FROZEN_MAP_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "eytzinger.h"
+
+namespace s21 {
+// read-only Map in Eytzinger order: keys and values in parallel arrays
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class frozen_map : public Eytzinger<Key, T, Compare> {
+  using tree_type = Eytzinger<Key, T, Compare>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = typename tree_type::reference;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = iterator;
+  using size_type = size_t;
+  using key_compare = Compare;
+
+  //  frozen_map Member functions
+  frozen_map() : tree_type() {}
+
+  explicit frozen_map(const Compare& compare) : tree_type(compare) {}
+
+  frozen_map(std::initializer_list<value_type> const& items,
+             const Compare& compare = Compare())
+      : tree_type(compare) {
+    this->build_any(items.begin(), items.end());
+  }
+
+  // repeated keys keep the first one
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  frozen_map(InputIt first, InputIt last, const Compare& compare = Compare())
+      : tree_type(compare) {
+    this->build_any(first, last);
+  }
+
+  // O(n) for input that is already sorted and unique; the tag alone picks
+  // this overload, so tree iterators without iterator_traits fit too
+  template <typename InputIt>
+  frozen_map(sorted_unique_t, InputIt first, InputIt last,
+             const Compare& compare = Compare())
+      : tree_type(compare) {
+    this->build_sorted(first, last);
+  }
+
+  //  element access
+  const T& at(const Key& key) const {
+    std::size_t index = this->find_index(key);
+    if (index == 0) {
+      throw std::out_of_range("No elements with such key");
+    }
+    return this->element(index).second;
+  }
+
+  void swap(frozen_map& other) { this->swap_eytzinger(other); }
+
+  //  lookup
+  iterator find(const Key& key) const {
+    return iterator(this, this->find_index(key));
+  }
+
+  bool contains(const Key& key) const { return this->find_index(key) != 0; }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    return iterator(this, this->lower_index(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return iterator(this, this->upper_index(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  // a transparent Compare looks up by any comparable K, no Key is built
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return iterator(this, this->find_index(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return this->find_index(key) != 0;
+  }
+
+  // one iterator per key of [first, last), end() for a miss
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    this->lower_index_batch(
+        first, last, [this, &out](const auto& key, std::size_t index) {
+          bool hit = index != 0 &&
+                     !this->compare_(key, this->element(index).first);
+          *out++ = iterator(this, hit ? index : 0);
+        });
+    return out;
+  }
+
+  template <typename Keys, typename OutputIt>
+  OutputIt find_many(const Keys& keys, OutputIt out) const {
+    return find_many(std::begin(keys), std::end(keys), out);
+  }
+
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt contains_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    this->lower_index_batch(
+        first, last, [this, &out](const auto& key, std::size_t index) {
+          *out++ = index != 0 &&
+                   !this->compare_(key, this->element(index).first);
+        });
+    return out;
+  }
+
+  template <typename Keys, typename OutputIt>
+  OutputIt contains_many(const Keys& keys, OutputIt out) const {
+    return contains_many(std::begin(keys), std::end(keys), out);
+  }
+};
+}  // namespace s21
+
+#endif  // S21_FROZEN_MAP_H_
@@ -0,0 +1,492 @@
+#ifndef S21_HASH_TABLE_H_
+#define S21_HASH_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../utils/defines.h"
+
+namespace s21 {
+/*
+ * Группа из 16 управляющих байтов. Пустой слот - 0x80, занятый хранит
+ * младшие 7 бит хеша (h2), поэтому признак пустоты - старший бит. С SSE2
+ * группа сравнивается одной инструкцией, маска совпадений - movemask
+ */
+struct hash_group_ {
+  static constexpr std::size_t kWidth = 16;
+  static constexpr std::uint8_t kEmpty = 0x80;
+
+#if defined(__SSE2__)
+  explicit hash_group_(const std::uint8_t* t_ctrl) noexcept
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t_ctrl))) {}
+
+  unsigned match(std::uint8_t t_h2) const noexcept {
+    return static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(t_h2)), ctrl_)));
+  }
+
+  unsigned match_empty() const noexcept {
+    return static_cast<unsigned>(_mm_movemask_epi8(ctrl_));
+  }
+
+ private:
+  __m128i ctrl_;
+#else
+  explicit hash_group_(const std::uint8_t* t_ctrl) noexcept {
+    std::memcpy(ctrl_, t_ctrl, kWidth);
+  }
+
+  unsigned match(std::uint8_t t_h2) const noexcept {
+    unsigned mask = 0;
+    for (std::size_t i = 0; i < kWidth; ++i) {
+      mask |= static_cast<unsigned>(ctrl_[i] == t_h2) << i;
+    }
+    return mask;
+  }
+
+  unsigned match_empty() const noexcept { return match(kEmpty); }
+
+ private:
+  std::uint8_t ctrl_[kWidth];
+#endif
+};
+
+/*
+ * Хеш-таблица с открытой адресацией в стиле swiss table. Слоты просматриваются
+ * линейно, но по 16 управляющих байтов за раз; хвост массива управляющих
+ * байтов дублирует его начало, чтобы группа у конца читалась одной загрузкой.
+ * Удаление сдвигает следующие элементы цепочки назад вместо надгробий, так
+ * что элемент всегда лежит между своим домашним слотом и первым пустым.
+ * Для T = void это множество. Вставка и удаление инвалидируют итераторы.
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class HashTable {
+ protected:
+  using slot_type =
+      std::conditional_t<std::is_void_v<T>, Key, std::pair<Key, T>>;
+  using slot_allocator_type = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<slot_type>;
+  using slot_traits = std::allocator_traits<slot_allocator_type>;
+  using ctrl_allocator_type = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<std::uint8_t>;
+  using ctrl_traits = std::allocator_traits<ctrl_allocator_type>;
+
+  static constexpr std::size_t kWidth = hash_group_::kWidth;
+  static constexpr std::uint8_t kEmpty = hash_group_::kEmpty;
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+ public:
+  using key_type = Key;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+  using reference =
+      std::conditional_t<std::is_void_v<T>, const Key&,
+                         std::pair<const Key&, std::add_lvalue_reference_t<
+                                                   std::conditional_t<
+                                                       std::is_void_v<T>, int,
+                                                       T>>>>;
+
+  class iterator {
+   public:
+    using reference = typename HashTable::reference;
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+    using pointer = void;
+
+    // для operator-> у пар из ссылок
+    struct arrow_proxy {
+      reference ref;
+      std::remove_reference_t<reference>* operator->() noexcept {
+        return std::addressof(ref);
+      }
+    };
+
+    iterator() = default;
+    iterator(const HashTable* t_table, std::size_t t_index)
+        : table_(t_table), index_(t_index) {}
+
+    reference operator*() const { return table_->element(index_); }
+
+    arrow_proxy operator->() const { return arrow_proxy{**this}; }
+
+    iterator& operator++() noexcept {
+      index_ = table_->next_full(index_ + 1);
+      return *this;
+    }
+
+    bool operator==(const iterator& t_other) const noexcept {
+      return index_ == t_other.index_;
+    }
+
+    bool operator!=(const iterator& t_other) const noexcept {
+      return !(*this == t_other);
+    }
+
+   private:
+    friend class HashTable;
+
+    const HashTable* table_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+ public:
+  HashTable() : HashTable(Hash()) {}
+
+  explicit HashTable(const Hash& t_hash, const KeyEqual& t_equal = KeyEqual(),
+                     const Allocator& t_alloc = Allocator())
+      : hash_(t_hash),
+        equal_(t_equal),
+        slot_allocator_(t_alloc),
+        ctrl_allocator_(t_alloc) {}
+
+  explicit HashTable(const Allocator& t_alloc)
+      : HashTable(Hash(), KeyEqual(), t_alloc) {}
+
+  HashTable(const HashTable& t_other)
+      : hash_(t_other.hash_),
+        equal_(t_other.equal_),
+        slot_allocator_(
+            slot_traits::select_on_container_copy_construction(
+                t_other.slot_allocator_)),
+        ctrl_allocator_(
+            ctrl_traits::select_on_container_copy_construction(
+                t_other.ctrl_allocator_)) {
+    copy_table(t_other);
+  }
+
+  HashTable(HashTable&& t_other) noexcept
+      : hash_(t_other.hash_),
+        equal_(t_other.equal_),
+        slot_allocator_(std::move(t_other.slot_allocator_)),
+        ctrl_allocator_(std::move(t_other.ctrl_allocator_)) {
+    steal(t_other);
+  }
+
+  HashTable& operator=(const HashTable& t_other) {
+    if (this != &t_other) {
+      HashTable copy(t_other);
+      swap_table(copy);
+    }
+    return *this;
+  }
+
+  HashTable& operator=(HashTable&& t_other) noexcept {
+    if (this != &t_other) {
+      release();
+      hash_ = t_other.hash_;
+      equal_ = t_other.equal_;
+      slot_allocator_ = std::move(t_other.slot_allocator_);
+      ctrl_allocator_ = std::move(t_other.ctrl_allocator_);
+      steal(t_other);
+    }
+    return *this;
+  }
+
+  ~HashTable() { release(); }
+
+  allocator_type get_allocator() const {
+    return allocator_type(slot_allocator_);
+  }
+
+  hasher hash_function() const { return hash_; }
+
+  key_equal key_eq() const { return equal_; }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type max_size() const noexcept {
+    return slot_traits::max_size(slot_allocator_) / 8 * 7;
+  }
+
+  size_type capacity() const noexcept { return capacity_; }
+
+  float load_factor() const noexcept {
+    return capacity_ ? static_cast<float>(size_) / capacity_ : 0.0f;
+  }
+
+  float max_load_factor() const noexcept { return 0.875f; }
+
+  iterator begin() const noexcept { return iterator(this, next_full(0)); }
+
+  iterator end() const noexcept { return iterator(this, capacity_); }
+
+  void clear() noexcept {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      if (full(i)) slot_traits::destroy(slot_allocator_, slots_ + i);
+    }
+    if (ctrl_) std::memset(ctrl_, kEmpty, capacity_ + kWidth - 1);
+    size_ = 0;
+  }
+
+  // после reserve(n) вставка до n элементов не перестраивает таблицу
+  void reserve(size_type t_count) {
+    std::size_t capacity = defines::DEFAULT_TABLE_SIZE;
+    while (capacity / 8 * 7 < t_count) capacity *= 2;
+    if (capacity > capacity_) rehash_table(capacity);
+  }
+
+ protected:
+  static std::size_t index_of(iterator t_pos) noexcept { return t_pos.index_; }
+
+  static std::size_t mix(std::size_t t_hash) noexcept {
+    // std::hash целых - тождественная функция, биты нужно перемешать
+    std::uint64_t h = static_cast<std::uint64_t>(t_hash) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(h ^ (h >> 32));
+  }
+
+  static std::uint8_t h2(std::size_t t_hash) noexcept {
+    return static_cast<std::uint8_t>(t_hash & 0x7F);
+  }
+
+  std::size_t home(std::size_t t_hash) const noexcept {
+    return (t_hash >> 7) & (capacity_ - 1);
+  }
+
+  template <typename K>
+  std::size_t hash_of(const K& t_key) const {
+    return mix(hash_(t_key));
+  }
+
+  static const Key& key_of(const slot_type& t_slot) noexcept {
+    if constexpr (std::is_void_v<T>) {
+      return t_slot;
+    } else {
+      return t_slot.first;
+    }
+  }
+
+  reference element(std::size_t t_index) const {
+    slot_type& slot = slots_[t_index];
+    if constexpr (std::is_void_v<T>) {
+      return slot;
+    } else {
+      return reference(slot.first, slot.second);
+    }
+  }
+
+  bool full(std::size_t t_index) const noexcept {
+    return (ctrl_[t_index] & kEmpty) == 0;
+  }
+
+  std::size_t next_full(std::size_t t_index) const noexcept {
+    while (t_index < capacity_ && !full(t_index)) ++t_index;
+    return t_index;
+  }
+
+  void set_ctrl(std::size_t t_index, std::uint8_t t_value) noexcept {
+    ctrl_[t_index] = t_value;
+    // зеркальная копия начала для чтения групп через конец массива
+    if (t_index < kWidth - 1) ctrl_[capacity_ + t_index] = t_value;
+  }
+
+  //  поиск
+  template <typename K>
+  std::size_t find_index(const K& t_key, std::size_t t_hash) const {
+    if (capacity_ == 0) return npos;
+    std::size_t mask = capacity_ - 1;
+    std::uint8_t tag = h2(t_hash);
+    for (std::size_t pos = home(t_hash);; pos = (pos + kWidth) & mask) {
+      hash_group_ group(ctrl_ + pos);
+      for (unsigned bits = group.match(tag); bits; bits &= bits - 1) {
+        std::size_t index = (pos + __builtin_ctz(bits)) & mask;
+        if (equal_(key_of(slots_[index]), t_key)) return index;
+      }
+      if (group.match_empty()) return npos;
+    }
+  }
+
+  template <typename K>
+  iterator find_table(const K& t_key) const {
+    std::size_t index = find_index(t_key, hash_of(t_key));
+    return iterator(this, index == npos ? capacity_ : index);
+  }
+
+  // первый пустой слот от домашнего; свободный слот есть всегда
+  std::size_t find_empty(std::size_t t_hash) const noexcept {
+    std::size_t mask = capacity_ - 1;
+    for (std::size_t pos = home(t_hash);; pos = (pos + kWidth) & mask) {
+      unsigned bits = hash_group_(ctrl_ + pos).match_empty();
+      if (bits) return (pos + __builtin_ctz(bits)) & mask;
+    }
+  }
+
+  //  вставка
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> emplace_unique_table(const K& t_key,
+                                                 Args&&... t_args) {
+    std::size_t hash = hash_of(t_key);
+    std::size_t index = find_index(t_key, hash);
+    if (index != npos) return std::make_pair(iterator(this, index), false);
+    if (size_ + 1 > capacity_ / 8 * 7) {
+      rehash_table(capacity_ ? capacity_ * 2 : defines::DEFAULT_TABLE_SIZE);
+    }
+    index = find_empty(hash);
+    slot_traits::construct(slot_allocator_, slots_ + index,
+                           std::forward<Args>(t_args)...);
+    set_ctrl(index, h2(hash));
+    ++size_;
+    return std::make_pair(iterator(this, index), true);
+  }
+
+  template <typename InputIt>
+  void insert_range_table(InputIt t_first, InputIt t_last) {
+    for (; t_first != t_last; ++t_first) {
+      if constexpr (std::is_void_v<T>) {
+        emplace_unique_table(*t_first, *t_first);
+      } else {
+        emplace_unique_table((*t_first).first, (*t_first).first,
+                             (*t_first).second);
+      }
+    }
+  }
+
+  //  удаление
+  /*
+   * обратный сдвиг: каждый следующий элемент цепочки, чей домашний слот не
+   * лежит в (hole, j], переезжает в дыру; цепочка кончается пустым слотом
+   */
+  void erase_index(std::size_t t_index) {
+    std::size_t mask = capacity_ - 1;
+    slot_traits::destroy(slot_allocator_, slots_ + t_index);
+    std::size_t hole = t_index;
+    for (std::size_t j = (hole + 1) & mask; full(j); j = (j + 1) & mask) {
+      std::size_t origin = home(hash_of(key_of(slots_[j])));
+      if (((j - origin) & mask) >= ((j - hole) & mask)) {
+        slot_traits::construct(slot_allocator_, slots_ + hole,
+                               std::move(slots_[j]));
+        slot_traits::destroy(slot_allocator_, slots_ + j);
+        set_ctrl(hole, ctrl_[j]);
+        hole = j;
+      }
+    }
+    set_ctrl(hole, kEmpty);
+    --size_;
+  }
+
+  template <typename K>
+  size_type erase_key_table(const K& t_key) {
+    std::size_t index = find_index(t_key, hash_of(t_key));
+    if (index == npos) return 0;
+    erase_index(index);
+    return 1;
+  }
+
+  //  целая таблица
+  // новая таблица заполняется целиком до того, как заменить старую
+  void rehash_table(std::size_t t_capacity) {
+    HashTable bigger(hash_, equal_, allocator_type(slot_allocator_));
+    bigger.allocate_arrays(t_capacity);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      if (!full(i)) continue;
+      std::size_t hash = hash_of(key_of(slots_[i]));
+      std::size_t index = bigger.find_empty(hash);
+      slot_traits::construct(bigger.slot_allocator_, bigger.slots_ + index,
+                             std::move_if_noexcept(slots_[i]));
+      bigger.set_ctrl(index, h2(hash));
+      ++bigger.size_;
+    }
+    swap_table(bigger);
+  }
+
+  void allocate_arrays(std::size_t t_capacity) {
+    ctrl_ = ctrl_traits::allocate(ctrl_allocator_, t_capacity + kWidth - 1);
+    try {
+      slots_ = slot_traits::allocate(slot_allocator_, t_capacity);
+    } catch (...) {
+      ctrl_traits::deallocate(ctrl_allocator_, ctrl_, t_capacity + kWidth - 1);
+      ctrl_ = nullptr;
+      THROW_FURTHER;
+    }
+    capacity_ = t_capacity;
+    std::memset(ctrl_, kEmpty, capacity_ + kWidth - 1);
+  }
+
+  // копия повторяет раскладку слотов, пересчет хешей не нужен
+  void copy_table(const HashTable& t_other) {
+    if (t_other.capacity_ == 0) return;
+    allocate_arrays(t_other.capacity_);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      if (!t_other.full(i)) continue;
+      slot_traits::construct(slot_allocator_, slots_ + i, t_other.slots_[i]);
+      set_ctrl(i, t_other.ctrl_[i]);
+      ++size_;
+    }
+  }
+
+  void release() noexcept {
+    if (capacity_ == 0) return;
+    clear();
+    slot_traits::deallocate(slot_allocator_, slots_, capacity_);
+    ctrl_traits::deallocate(ctrl_allocator_, ctrl_, capacity_ + kWidth - 1);
+    slots_ = nullptr;
+    ctrl_ = nullptr;
+    capacity_ = 0;
+  }
+
+  void steal(HashTable& t_other) noexcept {
+    slots_ = std::exchange(t_other.slots_, nullptr);
+    ctrl_ = std::exchange(t_other.ctrl_, nullptr);
+    capacity_ = std::exchange(t_other.capacity_, 0);
+    size_ = std::exchange(t_other.size_, 0);
+  }
+
+  void swap_table(HashTable& t_other) noexcept {
+    std::swap(slots_, t_other.slots_);
+    std::swap(ctrl_, t_other.ctrl_);
+    std::swap(capacity_, t_other.capacity_);
+    std::swap(size_, t_other.size_);
+    std::swap(hash_, t_other.hash_);
+    std::swap(equal_, t_other.equal_);
+    std::swap(slot_allocator_, t_other.slot_allocator_);
+    std::swap(ctrl_allocator_, t_other.ctrl_allocator_);
+  }
+
+  // недостающие ключи переезжают сюда, остальные остаются в t_other
+  void merge_table(HashTable& t_other) {
+    if (this == &t_other) return;
+    for (std::size_t i = 0; i < t_other.capacity_;) {
+      if (!t_other.full(i)) {
+        ++i;
+        continue;
+      }
+      slot_type& slot = t_other.slots_[i];
+      if (emplace_unique_table(key_of(slot), std::move_if_noexcept(slot))
+              .second) {
+        // на место i мог сдвинуться следующий элемент, i не двигаем
+        t_other.erase_index(i);
+      } else {
+        ++i;
+      }
+    }
+  }
+
+  slot_type* slots_ = nullptr;
+  std::uint8_t* ctrl_ = nullptr;
+  std::size_t capacity_ = 0;
+  std::size_t size_ = 0;
+  Hash hash_;
+  KeyEqual equal_;
+  slot_allocator_type slot_allocator_;
+  ctrl_allocator_type ctrl_allocator_;
+};
+}  // namespace s21
+
+#endif  // S21_HASH_TABLE_H_
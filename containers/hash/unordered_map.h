@@ -0,0 +1,160 @@
+#ifndef S21_UNORDERED_MAP_H_
+#define S21_UNORDERED_MAP_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "hash_table.h"
+
+namespace s21 {
+// hash map on an open-addressing table, no ordering
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class unordered_map : public HashTable<Key, T, Hash, KeyEqual, Allocator> {
+  using table_type = HashTable<Key, T, Hash, KeyEqual, Allocator>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = typename table_type::reference;
+  using iterator = typename table_type::iterator;
+  using size_type = size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+
+  //  unordered_map Member functions
+  unordered_map() : table_type() {}
+
+  explicit unordered_map(size_type bucket_count, const Hash& hash = Hash(),
+                         const KeyEqual& equal = KeyEqual(),
+                         const Allocator& alloc = Allocator())
+      : table_type(hash, equal, alloc) {
+    this->reserve(bucket_count);
+  }
+
+  explicit unordered_map(const Allocator& alloc) : table_type(alloc) {}
+
+  unordered_map(std::initializer_list<value_type> const& items,
+                size_type bucket_count = 0, const Hash& hash = Hash(),
+                const KeyEqual& equal = KeyEqual(),
+                const Allocator& alloc = Allocator())
+      : table_type(hash, equal, alloc) {
+    this->reserve(bucket_count > items.size() ? bucket_count : items.size());
+    this->insert_range_table(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  unordered_map(InputIt first, InputIt last, size_type bucket_count = 0,
+                const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                const Allocator& alloc = Allocator())
+      : table_type(hash, equal, alloc) {
+    this->reserve(bucket_count);
+    this->insert_range_table(first, last);
+  }
+
+  //  element access
+  T& at(const Key& key) {
+    iterator it = find(key);
+    if (it == this->end()) {
+      throw std::out_of_range("No elements with such key");
+    }
+    return (*it).second;
+  }
+
+  T& operator[](const Key& key) { return (*try_emplace(key).first).second; }
+
+  //  modifiers
+  // later elements of the probe chain shift back, other iterators go stale
+  void erase(iterator pos) { this->erase_index(this->index_of(pos)); }
+
+  size_type erase(const Key& key) { return this->erase_key_table(key); }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return this->emplace_unique_table(value.first, value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return this->emplace_unique_table(key, key, obj);
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_table(first, last);
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
+    auto inserted = this->emplace_unique_table(key, key, obj);
+    if (!inserted.second) (*inserted.first).second = obj;
+    return inserted;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return this->emplace_unique_table(
+        key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return this->emplace_unique_table(
+        key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename K, typename M>
+  std::pair<iterator, bool> emplace(K&& key, M&& mapped) {
+    return this->emplace_unique_table(key, std::forward<K>(key),
+                                      std::forward<M>(mapped));
+  }
+
+  void swap(unordered_map& other) { this->swap_table(other); }
+
+  // keys missing here move over, the rest stay in other
+  void merge(unordered_map& other) { this->merge_table(other); }
+
+  //  lookup
+  iterator find(const Key& key) const { return this->find_table(key); }
+
+  bool contains(const Key& key) const { return find(key) != this->end(); }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  // transparent Hash and KeyEqual look up by any compatible K
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent,
+            typename = typename E::is_transparent>
+  iterator find(const K& key) const {
+    return this->find_table(key);
+  }
+
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent,
+            typename = typename E::is_transparent>
+  bool contains(const K& key) const {
+    return this->find_table(key) != this->end();
+  }
+
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent,
+            typename = typename E::is_transparent>
+  size_type count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+};
+}  // namespace s21
+
+#endif  // S21_UNORDERED_MAP_H_
@@ -0,0 +1,126 @@
+#ifndef S21_UNORDERED_SET_H_
+#define S21_UNORDERED_SET_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "hash_table.h"
+
+namespace s21 {
+// hash set on an open-addressing table, no ordering
+template <typename Key, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<Key>>
+class unordered_set : public HashTable<Key, void, Hash, KeyEqual, Allocator> {
+  using table_type = HashTable<Key, void, Hash, KeyEqual, Allocator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename table_type::iterator;
+  using size_type = size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+
+  //  unordered_set Member functions
+  unordered_set() : table_type() {}
+
+  explicit unordered_set(size_type bucket_count, const Hash& hash = Hash(),
+                         const KeyEqual& equal = KeyEqual(),
+                         const Allocator& alloc = Allocator())
+      : table_type(hash, equal, alloc) {
+    this->reserve(bucket_count);
+  }
+
+  explicit unordered_set(const Allocator& alloc) : table_type(alloc) {}
+
+  unordered_set(std::initializer_list<Key> const& items,
+                size_type bucket_count = 0, const Hash& hash = Hash(),
+                const KeyEqual& equal = KeyEqual(),
+                const Allocator& alloc = Allocator())
+      : table_type(hash, equal, alloc) {
+    this->reserve(bucket_count > items.size() ? bucket_count : items.size());
+    this->insert_range_table(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  unordered_set(InputIt first, InputIt last, size_type bucket_count = 0,
+                const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                const Allocator& alloc = Allocator())
+      : table_type(hash, equal, alloc) {
+    this->reserve(bucket_count);
+    this->insert_range_table(first, last);
+  }
+
+  //  modifiers
+  // later elements of the probe chain shift back, other iterators go stale
+  void erase(iterator pos) { this->erase_index(this->index_of(pos)); }
+
+  size_type erase(const Key& key) { return this->erase_key_table(key); }
+
+  std::pair<iterator, bool> insert(const Key& value) {
+    return this->emplace_unique_table(value, value);
+  }
+
+  std::pair<iterator, bool> insert(Key&& value) {
+    return this->emplace_unique_table(value, std::move(value));
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_table(first, last);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return insert(Key(std::forward<Args>(args)...));
+  }
+
+  void swap(unordered_set& other) { this->swap_table(other); }
+
+  // keys missing here move over, the rest stay in other
+  void merge(unordered_set& other) { this->merge_table(other); }
+
+  //  lookup
+  iterator find(const Key& key) const { return this->find_table(key); }
+
+  bool contains(const Key& key) const { return find(key) != this->end(); }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  // transparent Hash and KeyEqual look up by any compatible K
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent,
+            typename = typename E::is_transparent>
+  iterator find(const K& key) const {
+    return this->find_table(key);
+  }
+
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent,
+            typename = typename E::is_transparent>
+  bool contains(const K& key) const {
+    return this->find_table(key) != this->end();
+  }
+
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent,
+            typename = typename E::is_transparent>
+  size_type count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+};
+}  // namespace s21
+
+#endif  // S21_UNORDERED_SET_H_
@@ -0,0 +1,161 @@
+#ifndef S21_MAPPED_FORMAT_H_
+#define S21_MAPPED_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../utils/defines.h"
+
+namespace s21 {
+/*
+ * Образ упорядоченного контейнера на диске. Все смещения отсчитываются от
+ * начала файла, поэтому образ не зависит от адреса отображения. Секции
+ * выровнены на MAPPED_SECTION_ALIGN байт:
+ *   заголовок | ключи по порядку | значения в том же порядке (у множеств
+ *   нет) | разреженный индекс - каждый index_stride-й ключ
+ * Индекс мал и держится в кэше, после него поиск трогает одну страницу
+ * ключей. Ключи и значения пишутся байт в байт, поэтому они обязаны быть
+ * тривиально копируемыми, а файл читается только на машине с тем же
+ * порядком байт и размерами типов - это проверяет заголовок
+ */
+struct mapped_header_ {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t count;
+  std::uint32_t key_size;
+  // 0 for sets
+  std::uint32_t value_size;
+  std::uint64_t keys_offset;
+  std::uint64_t values_offset;
+  std::uint64_t index_offset;
+  std::uint64_t index_count;
+  std::uint64_t index_stride;
+};
+
+inline constexpr char MAPPED_MAGIC[8] = {'S', '2', '1', 'M', 'A', 'P', 0, 0};
+constexpr std::uint32_t MAPPED_FORMAT_VERSION = 1;
+constexpr std::uint32_t MAPPED_BYTE_ORDER = 0x01020304;
+constexpr std::size_t MAPPED_SECTION_ALIGN = 64;
+// keys per index entry: one 4 KiB page of keys
+constexpr std::size_t MAPPED_INDEX_PAGE = 4096;
+
+inline std::uint64_t mapped_align_(std::uint64_t t_offset) noexcept {
+  return (t_offset + MAPPED_SECTION_ALIGN - 1) / MAPPED_SECTION_ALIGN *
+         MAPPED_SECTION_ALIGN;
+}
+
+template <typename Key>
+constexpr std::size_t mapped_stride_() noexcept {
+  return sizeof(Key) >= MAPPED_INDEX_PAGE ? 1
+                                          : MAPPED_INDEX_PAGE / sizeof(Key);
+}
+
+template <typename T>
+constexpr std::size_t mapped_value_size_() noexcept {
+  if constexpr (std::is_void_v<T>) {
+    return 0;
+  } else {
+    return sizeof(T);
+  }
+}
+
+template <typename Key, typename T>
+constexpr void mapped_check_types_() noexcept {
+  static_assert(std::is_trivially_copyable_v<Key>,
+                "mapped images store keys byte for byte");
+  static_assert(alignof(Key) <= MAPPED_SECTION_ALIGN, "key over-aligned");
+  if constexpr (!std::is_void_v<T>) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "mapped images store values byte for byte");
+    static_assert(alignof(T) <= MAPPED_SECTION_ALIGN, "value over-aligned");
+  }
+}
+
+/*
+ * Пишет образ [t_first, t_last) - элементов дерева в порядке ключей - во
+ * временный файл рядом и переименовывает его в t_path, так что упавшая
+ * запись не портит прежний образ. Диапазон проходится трижды
+ */
+template <typename Key, typename T, typename ForwardIt>
+void save_mapped_image_(const std::string& t_path, ForwardIt t_first,
+                        ForwardIt t_last, std::size_t t_count) {
+  mapped_check_types_<Key, T>();
+  constexpr std::size_t value_size = mapped_value_size_<T>();
+  const std::uint64_t stride = mapped_stride_<Key>();
+
+  mapped_header_ header{};
+  std::memcpy(header.magic, MAPPED_MAGIC, sizeof(header.magic));
+  header.version = MAPPED_FORMAT_VERSION;
+  header.byte_order = MAPPED_BYTE_ORDER;
+  header.count = t_count;
+  header.key_size = sizeof(Key);
+  header.value_size = value_size;
+  header.keys_offset = mapped_align_(sizeof(mapped_header_));
+  header.values_offset =
+      mapped_align_(header.keys_offset + t_count * sizeof(Key));
+  header.index_offset =
+      mapped_align_(header.values_offset + t_count * value_size);
+  header.index_count = (t_count + stride - 1) / stride;
+  header.index_stride = stride;
+
+  const std::string temporary = t_path + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("cannot create " + temporary);
+    std::uint64_t written = 0;
+    auto write = [&out, &written](const void* t_data, std::size_t t_size) {
+      out.write(static_cast<const char*>(t_data),
+                static_cast<std::streamsize>(t_size));
+      written += t_size;
+    };
+    auto pad_to = [&write, &written](std::uint64_t t_offset) {
+      static const char zeros[MAPPED_SECTION_ALIGN] = {};
+      write(zeros, static_cast<std::size_t>(t_offset - written));
+    };
+    auto key_of = [](const auto& t_element) -> const Key& {
+      if constexpr (std::is_void_v<T>) {
+        return t_element;
+      } else {
+        return t_element.first;
+      }
+    };
+
+    write(&header, sizeof(header));
+    pad_to(header.keys_offset);
+    for (ForwardIt it = t_first; it != t_last; ++it) {
+      write(&key_of(*it), sizeof(Key));
+    }
+    if constexpr (!std::is_void_v<T>) {
+      pad_to(header.values_offset);
+      for (ForwardIt it = t_first; it != t_last; ++it) {
+        write(&(*it).second, sizeof(T));
+      }
+    }
+    pad_to(header.index_offset);
+    std::uint64_t position = 0;
+    for (ForwardIt it = t_first; it != t_last; ++it, ++position) {
+      if (position % stride == 0) write(&key_of(*it), sizeof(Key));
+    }
+    out.flush();
+    if (!out) {
+      out.close();
+      std::remove(temporary.c_str());
+      throw std::runtime_error("cannot write " + temporary);
+    }
+  }
+  if (std::rename(temporary.c_str(), t_path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("cannot replace " + t_path);
+  }
+}
+}  // namespace s21
+
+#endif  // S21_MAPPED_FORMAT_H_
@@ -0,0 +1,73 @@
+#ifndef S21_MAPPED_MAP_H_
+#define S21_MAPPED_MAP_H_
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "mapped_tree.h"
+
+namespace s21 {
+// read-only Map served straight from a file written by Map::save
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class mapped_map : public MappedTree<Key, T, Compare> {
+  using tree_type = MappedTree<Key, T, Compare>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = typename tree_type::reference;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = iterator;
+  using size_type = size_t;
+  using key_compare = Compare;
+
+  //  mapped_map Member functions
+  mapped_map() : tree_type() {}
+
+  explicit mapped_map(const Compare& compare) : tree_type(compare) {}
+
+  // maps the image at path; throws std::runtime_error when it cannot
+  static mapped_map open(const std::string& path,
+                         const Compare& compare = Compare()) {
+    mapped_map result(compare);
+    result.open_image(path);
+    return result;
+  }
+
+  //  element access
+  const T& at(const Key& key) const {
+    std::size_t index = this->find_index(key);
+    if (index == this->size()) {
+      throw std::out_of_range("No elements with such key");
+    }
+    return this->element(index).second;
+  }
+
+  //  lookup
+  iterator find(const Key& key) const {
+    return iterator(this, this->find_index(key));
+  }
+
+  bool contains(const Key& key) const {
+    return this->find_index(key) != this->size();
+  }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    return iterator(this, this->lower_index(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return iterator(this, this->upper_index(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+};
+}  // namespace s21
+
+#endif  // S21_MAPPED_MAP_H_
@@ -0,0 +1,63 @@
+#ifndef S21_MAPPED_SET_H_
+#define S21_MAPPED_SET_H_
+
+#include <string>
+#include <utility>
+
+#include "mapped_tree.h"
+
+namespace s21 {
+// read-only Set served straight from a file written by Set::save
+template <typename Key, typename Compare = std::less<Key>>
+class mapped_set : public MappedTree<Key, void, Compare> {
+  using tree_type = MappedTree<Key, void, Compare>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = iterator;
+  using size_type = size_t;
+  using key_compare = Compare;
+
+  //  mapped_set Member functions
+  mapped_set() : tree_type() {}
+
+  explicit mapped_set(const Compare& compare) : tree_type(compare) {}
+
+  // maps the image at path; throws std::runtime_error when it cannot
+  static mapped_set open(const std::string& path,
+                         const Compare& compare = Compare()) {
+    mapped_set result(compare);
+    result.open_image(path);
+    return result;
+  }
+
+  //  lookup
+  iterator find(const Key& key) const {
+    return iterator(this, this->find_index(key));
+  }
+
+  bool contains(const Key& key) const {
+    return this->find_index(key) != this->size();
+  }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    return iterator(this, this->lower_index(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return iterator(this, this->upper_index(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+};
+}  // namespace s21
+
+#endif  // S21_MAPPED_SET_H_
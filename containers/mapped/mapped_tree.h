@@ -0,0 +1,306 @@
+#ifndef S21_MAPPED_TREE_H_
+#define S21_MAPPED_TREE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "mapped_format.h"
+
+namespace s21 {
+/*
+ * Только читающий контейнер поверх отображенного в память образа из
+ * mapped_format.h. open() проверяет заголовок и границы секций, после
+ * этого поиск и обход идут прямо по страницам файла без разбора и
+ * копирования: двоичный поиск по разреженному индексу выбирает страницу
+ * ключей, второй поиск идет внутри нее. Compare должен совпадать с
+ * компаратором контейнера, который сохранил образ. Объект только
+ * перемещается, отображение снимается в деструкторе
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class MappedTree {
+  using value_slot = std::conditional_t<std::is_void_v<T>, char, T>;
+
+ public:
+  using key_type = Key;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+  using reference =
+      std::conditional_t<std::is_void_v<T>, const Key&,
+                         std::pair<const Key&, const value_slot&>>;
+
+  class iterator {
+   public:
+    using reference = typename MappedTree::reference;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+    using pointer = void;
+
+    // для operator-> у пар из ссылок
+    struct arrow_proxy {
+      reference ref;
+      std::remove_reference_t<reference>* operator->() noexcept {
+        return std::addressof(ref);
+      }
+    };
+
+    iterator() = default;
+    iterator(const MappedTree* t_tree, std::size_t t_index)
+        : tree_(t_tree), index_(t_index) {}
+
+    reference operator*() const { return tree_->element(index_); }
+
+    arrow_proxy operator->() const { return arrow_proxy{**this}; }
+
+    iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator copy = *this;
+      ++index_;
+      return copy;
+    }
+
+    iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    iterator operator--(int) noexcept {
+      iterator copy = *this;
+      --index_;
+      return copy;
+    }
+
+    bool operator==(const iterator& t_other) const noexcept {
+      return index_ == t_other.index_;
+    }
+
+    bool operator!=(const iterator& t_other) const noexcept {
+      return !(*this == t_other);
+    }
+
+   private:
+    const MappedTree* tree_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+  MappedTree() : MappedTree(Compare()) {}
+
+  explicit MappedTree(const Compare& t_compare) : compare_(t_compare) {
+    mapped_check_types_<Key, T>();
+  }
+
+  MappedTree(const MappedTree&) = delete;
+  MappedTree& operator=(const MappedTree&) = delete;
+
+  MappedTree(MappedTree&& t_other) noexcept { steal(t_other); }
+
+  MappedTree& operator=(MappedTree&& t_other) noexcept {
+    if (this != &t_other) {
+      unmap();
+      steal(t_other);
+    }
+    return *this;
+  }
+
+  ~MappedTree() { unmap(); }
+
+  key_compare key_comp() const { return compare_; }
+
+  bool empty() const noexcept { return count_ == 0; }
+
+  size_type size() const noexcept { return count_; }
+
+  iterator begin() const noexcept { return iterator(this, 0); }
+
+  iterator end() const noexcept { return iterator(this, count_); }
+
+ protected:
+  reference element(std::size_t t_index) const {
+    if constexpr (std::is_void_v<T>) {
+      return keys_[t_index];
+    } else {
+      return reference(keys_[t_index], values_[t_index]);
+    }
+  }
+
+  // бросает std::runtime_error, если файл нельзя открыть или он не образ
+  // контейнера с такими Key и T
+  void open_image(const std::string& t_path) {
+    int file = ::open(t_path.c_str(), O_RDONLY);
+    if (file < 0) fail("cannot open", t_path, errno);
+    struct stat info {};
+    if (::fstat(file, &info) != 0) {
+      int error = errno;
+      ::close(file);
+      fail("cannot stat", t_path, error);
+    }
+    std::size_t length = static_cast<std::size_t>(info.st_size);
+    if (length < sizeof(mapped_header_)) {
+      ::close(file);
+      fail("truncated image", t_path);
+    }
+    void* base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, file, 0);
+    int error = errno;
+    ::close(file);
+    if (base == MAP_FAILED) fail("cannot map", t_path, error);
+
+    const char* bytes = static_cast<const char*>(base);
+    mapped_header_ header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (!valid(header, length)) {
+      ::munmap(base, length);
+      fail("not a matching image", t_path);
+    }
+    unmap();
+    base_ = base;
+    length_ = length;
+    count_ = static_cast<std::size_t>(header.count);
+    stride_ = static_cast<std::size_t>(header.index_stride);
+    index_count_ = static_cast<std::size_t>(header.index_count);
+    keys_ = reinterpret_cast<const Key*>(bytes + header.keys_offset);
+    values_ =
+        reinterpret_cast<const value_slot*>(bytes + header.values_offset);
+    index_ = reinterpret_cast<const Key*>(bytes + header.index_offset);
+  }
+
+  //  поиск
+  /*
+   * индекс хранит первый ключ каждой страницы: последняя страница с
+   * первым ключом не больше искомого - та, где лежит ответ (или ответ -
+   * начало следующей)
+   */
+  template <typename K>
+  std::size_t lower_index(const K& t_key) const {
+    std::size_t page = first_not(index_, index_count_, [&](const Key& key) {
+      return compare_(key, t_key);
+    });
+    if (page == 0) return 0;
+    std::size_t from = (page - 1) * stride_;
+    std::size_t to = from + stride_ < count_ ? from + stride_ : count_;
+    return from + first_not(keys_ + from, to - from, [&](const Key& key) {
+             return compare_(key, t_key);
+           });
+  }
+
+  template <typename K>
+  std::size_t upper_index(const K& t_key) const {
+    std::size_t page = first_not(index_, index_count_, [&](const Key& key) {
+      return !compare_(t_key, key);
+    });
+    if (page == 0) return 0;
+    std::size_t from = (page - 1) * stride_;
+    std::size_t to = from + stride_ < count_ ? from + stride_ : count_;
+    return from + first_not(keys_ + from, to - from, [&](const Key& key) {
+             return !compare_(t_key, key);
+           });
+  }
+
+  template <typename K>
+  std::size_t find_index(const K& t_key) const {
+    std::size_t index = lower_index(t_key);
+    return index != count_ && !compare_(t_key, keys_[index]) ? index : count_;
+  }
+
+ private:
+  // первый элемент [t_base, t_base + t_size), для которого t_before ложно;
+  // шаг без ветвлений, как в FlatTree
+  template <typename Before>
+  static std::size_t first_not(const Key* t_base, std::size_t t_size,
+                               Before t_before) {
+    if (t_size == 0) return 0;
+    const Key* base = t_base;
+    std::size_t n = t_size;
+    while (n > 1) {
+      std::size_t half = n / 2;
+      base = t_before(base[half]) ? base + half : base;
+      n -= half;
+    }
+    return static_cast<std::size_t>(base - t_base) + t_before(*base);
+  }
+
+  static bool valid(const mapped_header_& t_header, std::size_t t_length) {
+    constexpr std::uint64_t value_size = mapped_value_size_<T>();
+    const std::uint64_t stride = mapped_stride_<Key>();
+    if (std::memcmp(t_header.magic, MAPPED_MAGIC, sizeof(MAPPED_MAGIC)) != 0 ||
+        t_header.version != MAPPED_FORMAT_VERSION ||
+        t_header.byte_order != MAPPED_BYTE_ORDER ||
+        t_header.key_size != sizeof(Key) ||
+        t_header.value_size != value_size ||
+        t_header.index_stride != stride) {
+      return false;
+    }
+    const std::uint64_t count = t_header.count;
+    if (count > t_length / sizeof(Key) ||
+        (value_size && count > t_length / value_size) ||
+        t_header.index_count != (count + stride - 1) / stride) {
+      return false;
+    }
+    auto section_fits = [t_length](std::uint64_t t_offset,
+                                   std::uint64_t t_bytes) {
+      return t_offset % MAPPED_SECTION_ALIGN == 0 && t_offset <= t_length &&
+             t_bytes <= t_length - t_offset;
+    };
+    return section_fits(t_header.keys_offset, count * sizeof(Key)) &&
+           section_fits(t_header.values_offset, count * value_size) &&
+           section_fits(t_header.index_offset,
+                        t_header.index_count * sizeof(Key));
+  }
+
+  [[noreturn]] static void fail(const char* t_what, const std::string& t_path,
+                                int t_error = 0) {
+    std::string reason = std::string(t_what) + " " + t_path;
+    if (t_error) reason += ": " + std::string(std::strerror(t_error));
+    throw std::runtime_error(reason);
+  }
+
+  void unmap() noexcept {
+    if (base_) ::munmap(base_, length_);
+    base_ = nullptr;
+    length_ = count_ = index_count_ = 0;
+    keys_ = index_ = nullptr;
+    values_ = nullptr;
+  }
+
+  void steal(MappedTree& t_other) noexcept {
+    base_ = std::exchange(t_other.base_, nullptr);
+    length_ = std::exchange(t_other.length_, 0);
+    count_ = std::exchange(t_other.count_, 0);
+    stride_ = t_other.stride_;
+    index_count_ = std::exchange(t_other.index_count_, 0);
+    keys_ = std::exchange(t_other.keys_, nullptr);
+    values_ = std::exchange(t_other.values_, nullptr);
+    index_ = std::exchange(t_other.index_, nullptr);
+    compare_ = t_other.compare_;
+  }
+
+  void* base_ = nullptr;
+  std::size_t length_ = 0;
+  std::size_t count_ = 0;
+  std::size_t stride_ = 1;
+  std::size_t index_count_ = 0;
+  const Key* keys_ = nullptr;
+  const value_slot* values_ = nullptr;
+  const Key* index_ = nullptr;
+  Compare compare_;
+};
+}  // namespace s21
+
+#endif  // S21_MAPPED_TREE_H_
@@ -0,0 +1,567 @@
+#ifndef S21_PERSISTENT_MAP_H_
+#define S21_PERSISTENT_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "../tree/tree.h"
+#include "../utils/defines.h"
+#include "../vector/vector.h"
+
+namespace s21 {
+/*
+ * Персистентный словарь на левостороннем красно-черном дереве. Узлы
+ * неизменяемы, пока на них ссылается больше одной версии: insert и erase
+ * копируют только пройденный путь O(log n), остальные поддеревья делятся
+ * между версиями через атомарный счетчик ссылок. Узел, которым владеет
+ * только текущая версия, меняется на месте, поэтому без живых снимков
+ * дерево работает как обычное. snapshot() и копирование - O(1). Снимок
+ * можно отдать другому потоку и читать без блокировок, пока владелец
+ * продолжает писать в свою версию; сам объект версии потокобезопасным
+ * не является
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class persistent_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+
+ private:
+  struct node {
+    value_type values;
+    std::atomic<size_t> refs{1};
+    TreeColor color = Red;
+    node* left = nullptr;
+    node* right = nullptr;
+    // number of elements in the subtree rooted at this node
+    size_t size = 1;
+
+    template <typename... Args>
+    explicit node(Args&&... t_args) : values(std::forward<Args>(t_args)...) {}
+
+    const Key& key() const noexcept { return values.first; }
+  };
+
+  using node_allocator_type = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator_type>;
+
+ public:
+  /*
+   * Итератор без ссылок на родителя: стек хранит предков текущего узла, от
+   * которых путь ушел влево, - его будущих преемников, поэтому ++ в среднем
+   * O(1). find и границы стек не строят, он собирается одним спуском от
+   * корня при первом ++. swap и перемещение версии итератор инвалидируют
+   */
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = persistent_map::value_type;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    iterator() = default;
+
+    reference operator*() const { return node_->values; }
+
+    pointer operator->() const { return std::addressof(node_->values); }
+
+    iterator& operator++() {
+      if (!path_) map_->trace(*this);
+      if (const node* next = node_->right) {
+        for (; next->left; next = next->left) path_->push_back(next);
+        node_ = next;
+      } else if (path_->empty()) {
+        node_ = nullptr;
+      } else {
+        node_ = path_->back();
+        path_->pop_back();
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const iterator& other) const noexcept {
+      return node_ == other.node_;
+    }
+
+    bool operator!=(const iterator& other) const noexcept {
+      return node_ != other.node_;
+    }
+
+   private:
+    friend class persistent_map;
+
+    iterator(const persistent_map* t_map, const node* t_node) noexcept
+        : map_(t_map), node_(t_node) {}
+
+    const persistent_map* map_ = nullptr;
+    const node* node_ = nullptr;
+    std::optional<vector<const node*>> path_;
+  };
+
+  using const_iterator = iterator;
+
+  //  persistent_map Member functions
+  persistent_map() : persistent_map(Compare()) {}
+
+  explicit persistent_map(const Compare& compare,
+                          const Allocator& alloc = Allocator())
+      : node_allocator_(alloc), compare_(compare) {}
+
+  explicit persistent_map(const Allocator& alloc)
+      : persistent_map(Compare(), alloc) {}
+
+  persistent_map(std::initializer_list<value_type> const& items,
+                 const Compare& compare = Compare(),
+                 const Allocator& alloc = Allocator())
+      : persistent_map(compare, alloc) {
+    for (const value_type& item : items) insert(item.first, item.second);
+  }
+
+  // версии делят все узлы, пока одна из них не изменится
+  persistent_map(const persistent_map& other)
+      : root_(acquire(other.root_)),
+        node_allocator_(other.node_allocator_),
+        compare_(other.compare_) {}
+
+  persistent_map(persistent_map&& other) noexcept
+      : root_(other.root_),
+        node_allocator_(other.node_allocator_),
+        compare_(other.compare_) {
+    other.root_ = nullptr;
+  }
+
+  persistent_map& operator=(const persistent_map& other) {
+    if (this != &other) {
+      node* shared = acquire(other.root_);
+      release(root_);
+      root_ = shared;
+      compare_ = other.compare_;
+    }
+    return *this;
+  }
+
+  persistent_map& operator=(persistent_map&& other) noexcept {
+    if (this != &other) {
+      release(root_);
+      root_ = other.root_;
+      other.root_ = nullptr;
+      compare_ = other.compare_;
+    }
+    return *this;
+  }
+
+  ~persistent_map() { release(root_); }
+
+  allocator_type get_allocator() const {
+    return allocator_type(node_allocator_);
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+  // неизменяемая копия текущей версии за O(1)
+  persistent_map snapshot() const { return *this; }
+
+  //  element access
+  const T& at(const Key& key) const {
+    const node* found = search(key);
+    if (!found) throw std::out_of_range("No elements with such key");
+    return found->values.second;
+  }
+
+  //  iterators
+  iterator begin() const {
+    iterator it(this, root_);
+    it.path_.emplace(0);
+    for (; it.node_ && it.node_->left; it.node_ = it.node_->left) {
+      it.path_->push_back(it.node_);
+    }
+    return it;
+  }
+
+  iterator end() const noexcept { return iterator(this, nullptr); }
+
+  //  capacity
+  bool empty() const noexcept { return root_ == nullptr; }
+
+  size_type size() const noexcept { return size_of(root_); }
+
+  //  modifiers
+  void clear() noexcept {
+    release(root_);
+    root_ = nullptr;
+  }
+
+  // true when the key was new; an existing value stays as it is
+  bool insert(const Key& key, const T& obj) {
+    if (search(key)) return false;
+    place(key, obj);
+    return true;
+  }
+
+  bool insert(const value_type& value) {
+    return insert(value.first, value.second);
+  }
+
+  // true when the key was new
+  bool insert_or_assign(const Key& key, const T& obj) {
+    bool inserted = !search(key);
+    place(key, obj);
+    return inserted;
+  }
+
+  /*
+   * Если удаление может задеть узлы других версий, их копии собираются
+   * при лишней ссылке на прежний корень: исключение возвращает версию к нему
+   */
+  size_type erase(const Key& key) {
+    if (!search(key)) return 0;
+    if (exclusive_around(key)) {
+      erase_root(key);
+      return 1;
+    }
+    node* backup = acquire(root_);
+    try {
+      erase_root(key);
+    } catch (...) {
+      release(root_);
+      root_ = backup;
+      THROW_FURTHER;
+    }
+    release(backup);
+    return 1;
+  }
+
+  void swap(persistent_map& other) noexcept {
+    std::swap(root_, other.root_);
+    std::swap(compare_, other.compare_);
+  }
+
+  //  lookup
+  iterator find(const Key& key) const { return iterator(this, search(key)); }
+
+  bool contains(const Key& key) const { return search(key) != nullptr; }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    const node* bound = nullptr;
+    for (const node* current = root_; current;) {
+      if (compare_(current->key(), key)) {
+        current = current->right;
+      } else {
+        bound = current;
+        current = current->left;
+      }
+    }
+    return iterator(this, bound);
+  }
+
+  iterator upper_bound(const Key& key) const {
+    const node* bound = nullptr;
+    for (const node* current = root_; current;) {
+      if (compare_(key, current->key())) {
+        bound = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return iterator(this, bound);
+  }
+
+ private:
+  static bool is_red(const node* t_node) noexcept {
+    return t_node && t_node->color == Red;
+  }
+
+  static size_t size_of(const node* t_node) noexcept {
+    return t_node ? t_node->size : 0;
+  }
+
+  static void update_size(node* t_node) noexcept {
+    t_node->size = 1 + size_of(t_node->left) + size_of(t_node->right);
+  }
+
+  static node* acquire(node* t_node) noexcept {
+    if (t_node) t_node->refs.fetch_add(1, std::memory_order_relaxed);
+    return t_node;
+  }
+
+  // последняя ссылка освобождает узел и отпускает его поддеревья
+  void release(node* t_node) noexcept {
+    if (!t_node || t_node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    release(t_node->left);
+    release(t_node->right);
+    node_traits::destroy(node_allocator_, t_node);
+    node_traits::deallocate(node_allocator_, t_node, 1);
+  }
+
+  template <typename... Args>
+  node* create_node(Args&&... t_args) {
+    node* created = node_traits::allocate(node_allocator_, 1);
+    try {
+      node_traits::construct(node_allocator_, created,
+                             std::forward<Args>(t_args)...);
+    } catch (...) {
+      node_traits::deallocate(node_allocator_, created, 1);
+      THROW_FURTHER;
+    }
+    return created;
+  }
+
+  // копия узла с теми же связями, поддеревья получают по ссылке
+  node* clone(const node* t_node) {
+    node* copy = create_node(t_node->values);
+    copy->color = t_node->color;
+    copy->left = acquire(t_node->left);
+    copy->right = acquire(t_node->right);
+    copy->size = t_node->size;
+    return copy;
+  }
+
+  /*
+   * Узел, доступный только этой версии, можно менять на месте. Путь
+   * берется во владение сверху вниз, поэтому единственная ссылка на узел
+   * приходит из уже собственного родителя и другим версиям он не виден
+   */
+  node* own(node* t_node) {
+    if (t_node->refs.load(std::memory_order_acquire) == 1) return t_node;
+    node* copy = clone(t_node);
+    release(t_node);
+    return copy;
+  }
+
+  const node* search(const Key& key) const {
+    const node* current = root_;
+    while (current) {
+      if (compare_(key, current->key())) {
+        current = current->left;
+      } else if (compare_(current->key(), key)) {
+        current = current->right;
+      } else {
+        break;
+      }
+    }
+    return current;
+  }
+
+  // стек итератора, стоящего на t_it.node_, собирается спуском от корня
+  void trace(iterator& t_it) const {
+    t_it.path_.emplace(0);
+    for (const node* current = root_; current != t_it.node_;) {
+      if (compare_(t_it.node_->key(), current->key())) {
+        t_it.path_->push_back(current);
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+  }
+
+  /*
+   * Повороты, перекраска и спуск пишут каждый взятый во владение узел в его
+   * слот сразу, до следующего шага, который может бросить. Иначе слот
+   * родителя указывал бы на уже отпущенный оригинал, а копия терялась
+   */
+  void rotate_left(node*& t_slot) {
+    t_slot->right = own(t_slot->right);
+    node* right = t_slot->right;
+    t_slot->right = right->left;
+    right->left = t_slot;
+    right->color = t_slot->color;
+    t_slot->color = Red;
+    right->size = t_slot->size;
+    update_size(t_slot);
+    t_slot = right;
+  }
+
+  void rotate_right(node*& t_slot) {
+    t_slot->left = own(t_slot->left);
+    node* left = t_slot->left;
+    t_slot->left = left->right;
+    left->right = t_slot;
+    left->color = t_slot->color;
+    t_slot->color = Red;
+    left->size = t_slot->size;
+    update_size(t_slot);
+    t_slot = left;
+  }
+
+  static TreeColor flipped(TreeColor color) noexcept {
+    return color == Red ? Black : Red;
+  }
+
+  void flip_colors(node* t_node) {
+    t_node->left = own(t_node->left);
+    t_node->right = own(t_node->right);
+    t_node->color = flipped(t_node->color);
+    t_node->left->color = flipped(t_node->left->color);
+    t_node->right->color = flipped(t_node->right->color);
+  }
+
+  void balance(node*& t_slot) {
+    if (is_red(t_slot->right) && !is_red(t_slot->left)) rotate_left(t_slot);
+    if (is_red(t_slot->left) && is_red(t_slot->left->left)) {
+      rotate_right(t_slot);
+    }
+    if (is_red(t_slot->left) && is_red(t_slot->right)) flip_colors(t_slot);
+    update_size(t_slot);
+  }
+
+  void place(const Key& key, const T& obj) {
+    place_at(root_, key, obj);
+    root_->color = Black;
+  }
+
+  /*
+   * Все, что может бросить - копии узлов, новый узел и присваивание
+   * значения, - случается на спуске, пока дерево не перестроено. Красный
+   * левый сосед на пути вправо берется заранее: его перекрасит flip_colors
+   */
+  void place_at(node*& t_slot, const Key& key, const T& obj) {
+    if (!t_slot) {
+      t_slot = create_node(key, obj);
+      return;
+    }
+    t_slot = own(t_slot);
+    if (compare_(key, t_slot->key())) {
+      place_at(t_slot->left, key, obj);
+    } else if (compare_(t_slot->key(), key)) {
+      if (is_red(t_slot->left)) t_slot->left = own(t_slot->left);
+      place_at(t_slot->right, key, obj);
+    } else {
+      t_slot->values.second = obj;
+    }
+    balance(t_slot);
+  }
+
+  void move_red_left(node*& t_slot) {
+    flip_colors(t_slot);
+    if (is_red(t_slot->right->left)) {
+      rotate_right(t_slot->right);
+      rotate_left(t_slot);
+      flip_colors(t_slot);
+    }
+  }
+
+  void move_red_right(node*& t_slot) {
+    flip_colors(t_slot);
+    if (is_red(t_slot->left->left)) {
+      rotate_right(t_slot);
+      flip_colors(t_slot);
+    }
+  }
+
+  static bool exclusive(const node* t_node) noexcept {
+    return !t_node || t_node->refs.load(std::memory_order_acquire) == 1;
+  }
+
+  /*
+   * Удаление трогает путь к ключу и дальше к минимуму справа, а также
+   * детей и внуков узлов пути. Если все они принадлежат только этой
+   * версии, own() ничего не копирует и удаление идет на месте без исключений
+   */
+  bool exclusive_around(const Key& key) const {
+    bool found = false;
+    for (const node* current = root_; current;) {
+      if (!exclusive(current)) return false;
+      for (const node* child : {current->left, current->right}) {
+        if (child && !(exclusive(child) && exclusive(child->left) &&
+                       exclusive(child->right))) {
+          return false;
+        }
+      }
+      if (found || compare_(key, current->key())) {
+        current = current->left;
+      } else if (compare_(current->key(), key)) {
+        current = current->right;
+      } else {
+        found = true;
+        current = current->right;
+      }
+    }
+    return true;
+  }
+
+  void erase_root(const Key& key) {
+    root_ = own(root_);
+    if (!is_red(root_->left) && !is_red(root_->right)) root_->color = Red;
+    erase_at(root_, key);
+    if (root_) root_->color = Black;
+  }
+
+  // t_slot уже во владении; минимум отцепляется и возвращается целиком
+  node* erase_min(node*& t_slot) {
+    if (!t_slot->left) return std::exchange(t_slot, nullptr);
+    if (!is_red(t_slot->left) && !is_red(t_slot->left->left)) {
+      move_red_left(t_slot);
+    }
+    t_slot->left = own(t_slot->left);
+    node* min = erase_min(t_slot->left);
+    balance(t_slot);
+    return min;
+  }
+
+  // ключ есть в поддереве, t_slot уже во владении
+  void erase_at(node*& t_slot, const Key& key) {
+    if (compare_(key, t_slot->key())) {
+      if (!is_red(t_slot->left) && !is_red(t_slot->left->left)) {
+        move_red_left(t_slot);
+      }
+      t_slot->left = own(t_slot->left);
+      erase_at(t_slot->left, key);
+    } else {
+      if (is_red(t_slot->left)) rotate_right(t_slot);
+      if (!compare_(t_slot->key(), key) && !t_slot->right) {
+        release(std::exchange(t_slot, nullptr));
+        return;
+      }
+      if (!is_red(t_slot->right) && !is_red(t_slot->right->left)) {
+        move_red_right(t_slot);
+      }
+      t_slot->right = own(t_slot->right);
+      if (!compare_(t_slot->key(), key)) {
+        // ключ константный, поэтому на место узла встает сам минимум справа
+        node* min = erase_min(t_slot->right);
+        min->left = std::exchange(t_slot->left, nullptr);
+        min->right = std::exchange(t_slot->right, nullptr);
+        min->color = t_slot->color;
+        release(std::exchange(t_slot, min));
+      } else {
+        erase_at(t_slot->right, key);
+      }
+    }
+    balance(t_slot);
+  }
+
+  node* root_ = nullptr;
+  node_allocator_type node_allocator_;
+  Compare compare_;
+};
+}  // namespace s21
+
+#endif  // S21_PERSISTENT_MAP_H_
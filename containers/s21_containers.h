@@ -1,13 +1,30 @@
 #ifndef S21_CONTAINERS_HPP_
 #define S21_CONTAINERS_HPP_
 
+#include "btree/btree_map.h"
+#include "btree/btree_set.h"
+#include "concurrent/concurrent_map.h"
+#include "flat/flat_map.h"
+#include "flat/flat_set.h"
+#include "frozen/frozen_map.h"
+#include "frozen/frozen_set.h"
+#include "hash/unordered_map.h"
+#include "hash/unordered_set.h"
 #include "list/list.h"
+#include "mapped/mapped_map.h"
+#include "mapped/mapped_set.h"
+#include "persistent/persistent_map.h"
 #include "queue/queue.h"
+#include "set-map/augmented_map.h"
 #include "set-map/map.h"
+#include "set-map/multimap.h"
+#include "set-map/multiset.h"
 #include "set-map/set.h"
+#include "skiplist/skiplist_map.h"
 #include "stack/stack.h"
 #include "tree/tree.h"
 #include "utils/defines.h"
+#include "utils/pool_allocator.h"
 #include "vector/vector.h"
 
 #endif
@@ -0,0 +1,368 @@
+#ifndef S21_AUGMENTED_MAP_H_
+#define S21_AUGMENTED_MAP_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "tree_iterator.h"
+
+namespace s21 {
+/*
+ * Моноиды для augmented_map: identity() - нейтральный элемент, lift -
+ * вклад одного значения, combine - ассоциативное объединение соседних
+ * отрезков (левый аргумент идет раньше по порядку ключей)
+ */
+template <typename T>
+struct aggregate_sum {
+  using value_type = T;
+  static value_type identity() { return value_type(); }
+  static value_type lift(const T& value) { return value; }
+  static value_type combine(const value_type& a, const value_type& b) {
+    return a + b;
+  }
+};
+
+template <typename T>
+struct aggregate_min {
+  using value_type = T;
+  static value_type identity() { return std::numeric_limits<T>::max(); }
+  static value_type lift(const T& value) { return value; }
+  static value_type combine(const value_type& a, const value_type& b) {
+    return b < a ? b : a;
+  }
+};
+
+template <typename T>
+struct aggregate_max {
+  using value_type = T;
+  static value_type identity() { return std::numeric_limits<T>::lowest(); }
+  static value_type lift(const T& value) { return value; }
+  static value_type combine(const value_type& a, const value_type& b) {
+    return a < b ? b : a;
+  }
+};
+
+template <typename T>
+struct aggregate_count {
+  using value_type = size_t;
+  static value_type identity() { return 0; }
+  static value_type lift(const T&) { return 1; }
+  static value_type combine(const value_type& a, const value_type& b) {
+    return a + b;
+  }
+};
+
+// mapped value of an augmented node: the user value and its subtree total
+template <typename T, typename Monoid>
+struct augmented_value_ {
+  T value;
+  typename Monoid::value_type total = Monoid::identity();
+
+  // implicit, so pairs of (Key, T) build nodes directly
+  augmented_value_(const T& t_value) : value(t_value) {}
+  augmented_value_(T&& t_value) : value(std::move(t_value)) {}
+};
+
+template <typename Key, typename T, typename Monoid>
+struct tree_augment_<Key, augmented_value_<T, Monoid>> {
+  static constexpr bool enabled = true;
+
+  static typename Monoid::value_type total(
+      const tree_el_<Key, augmented_value_<T, Monoid>>* node) {
+    return node ? node->values.second.total : Monoid::identity();
+  }
+
+  static void update(tree_el_<Key, augmented_value_<T, Monoid>>* node) {
+    node->values.second.total = Monoid::combine(
+        Monoid::combine(total(node->left),
+                        Monoid::lift(node->values.second.value)),
+        total(node->right));
+  }
+};
+
+/*
+ * Map, в каждом узле которого лежит агрегат моноида по его поддереву.
+ * Агрегат пересчитывается на пути вставки и удаления и в поворотах,
+ * поэтому aggregate(lo, hi) по полуинтервалу ключей стоит O(log n).
+ * Значения меняются только через insert_or_assign: итераторы отдают их
+ * на чтение, иначе агрегаты предков разошлись бы со значением
+ */
+template <typename Key, typename T, typename Monoid = aggregate_sum<T>,
+          typename Compare = std::less<Key>,
+          typename Allocator = pool_allocator<std::pair<const Key, T>>>
+class augmented_map
+    : public Tree<Key, augmented_value_<T, Monoid>, Compare, Allocator> {
+  using stored_type = augmented_value_<T, Monoid>;
+  using tree_type = Tree<Key, stored_type, Compare, Allocator>;
+  using node_type = tree_el_<Key, stored_type>;
+  using augment = tree_augment_<Key, stored_type>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = std::pair<const Key&, const T&>;
+  using const_reference = reference;
+  using aggregate_type = typename Monoid::value_type;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+
+  class iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = augmented_map::value_type;
+    using reference = augmented_map::reference;
+
+    struct arrow_proxy {
+      reference ref;
+      const reference* operator->() const { return &ref; }
+    };
+    using pointer = arrow_proxy;
+
+    iterator() = default;
+    explicit iterator(TreeIterator<Key, stored_type> t_iter) : iter_(t_iter) {}
+
+    reference operator*() const {
+      return reference(iter_.iter->values.first,
+                       iter_.iter->values.second.value);
+    }
+
+    arrow_proxy operator->() const { return arrow_proxy{**this}; }
+
+    iterator& operator++() {
+      ++iter_;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator copy = *this;
+      ++iter_;
+      return copy;
+    }
+
+    iterator& operator--() {
+      --iter_;
+      return *this;
+    }
+
+    iterator operator--(int) {
+      iterator copy = *this;
+      --iter_;
+      return copy;
+    }
+
+    bool operator==(const iterator& other) const { return iter_ == other.iter_; }
+
+    bool operator!=(const iterator& other) const { return iter_ != other.iter_; }
+
+   private:
+    friend class augmented_map;
+    TreeIterator<Key, stored_type> iter_;
+  };
+
+  using const_iterator = iterator;
+
+  //  augmented_map Member functions
+  augmented_map() : tree_type() {}
+
+  explicit augmented_map(const Allocator& alloc) : tree_type(alloc) {}
+
+  explicit augmented_map(const Compare& compare,
+                         const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {}
+
+  augmented_map(std::initializer_list<value_type> const& items,
+                const Compare& compare = Compare(),
+                const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  augmented_map(InputIt first, InputIt last, const Compare& compare = Compare(),
+                const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(first, last);
+  }
+
+  augmented_map(const augmented_map& other)
+      : tree_type(tree_type::node_traits::select_on_container_copy_construction(
+            other.node_allocator_)) {
+    *this = other;
+  }
+
+  augmented_map& operator=(const augmented_map& other) {
+    this->copy_tree(other);
+    return *this;
+  }
+
+  augmented_map(augmented_map&& other) : tree_type(other.get_allocator()) {
+    *this = std::move(other);
+  }
+
+  augmented_map& operator=(augmented_map&& other) {
+    this->move_tree(other);
+    return *this;
+  }
+
+  ~augmented_map() { clear(); }
+
+  //  element access
+  const T& at(const Key& key) const {
+    node_type* node = this->search_tree(this->root_, key);
+    if (node == nullptr) {
+      throw std::out_of_range("No elements with such key");
+    }
+    return node->values.second.value;
+  }
+
+  //  iterators
+  iterator begin() const noexcept {
+    return make_iterator(this->empty() ? nullptr : this->end_->right);
+  }
+
+  iterator end() const noexcept { return make_iterator(nullptr); }
+
+  //  modifiers
+  void erase(iterator pos) { this->erase_tree(pos.iter_.iter); }
+
+  size_type erase(const Key& key) {
+    node_type* node = this->search_tree(this->root_, key);
+    if (node == nullptr) return 0;
+    this->erase_tree(node);
+    return 1;
+  }
+
+  void clear() { this->clear_tree(); }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return insert(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    auto inserted = this->emplace_key_tree(nullptr, key, key, obj);
+    return std::make_pair(make_iterator(inserted.first), inserted.second);
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_tree(first, last);
+  }
+
+  // an existing value changes in place, its ancestors are refreshed
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
+    auto pos = this->find_insert_pos(key);
+    if (pos.node) {
+      pos.node->values.second.value = obj;
+      this->refresh_path_tree(pos.node);
+      return std::make_pair(make_iterator(pos.node), false);
+    }
+    return std::make_pair(
+        make_iterator(this->link_node(this->create_node(key, obj), pos)),
+        true);
+  }
+
+  void swap(augmented_map& other) { this->swap_tree(other); }
+
+  // keys missing here move over, the rest stay in other; O(n + m)
+  void merge(augmented_map& other) { this->merge_tree(other); }
+
+  //  lookup
+  iterator find(const Key& key) const {
+    return make_iterator(this->search_tree(this->root_, key));
+  }
+
+  bool contains(const Key& key) const {
+    return this->contains_tree(this->root_, key);
+  }
+
+  size_type count(const Key& key) const { return this->count_tree(key); }
+
+  iterator lower_bound(const Key& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  //  order statistics
+  iterator nth(size_type k) const noexcept {
+    return make_iterator(this->nth_tree(k));
+  }
+
+  size_type count_less(const Key& key) const {
+    return this->count_less_tree(key);
+  }
+
+  //  aggregates
+  aggregate_type aggregate() const { return augment::total(this->root_); }
+
+  /*
+   * агрегат ключей из [lo, hi): спуск до первого узла внутри отрезка,
+   * дальше две ветви к границам, от каждого узла берется целое поддерево
+   */
+  aggregate_type aggregate(const Key& lo, const Key& hi) const {
+    node_type* split = this->root_;
+    while (split) {
+      if (this->compare_(split->key(), lo)) {
+        split = split->right;
+      } else if (!this->compare_(split->key(), hi)) {
+        split = split->left;
+      } else {
+        break;
+      }
+    }
+    if (split == nullptr) return Monoid::identity();
+
+    aggregate_type left = Monoid::identity();
+    for (node_type* node = split->left; node;) {
+      if (this->compare_(node->key(), lo)) {
+        node = node->right;
+      } else {
+        left = Monoid::combine(
+            Monoid::combine(Monoid::lift(node->values.second.value),
+                            augment::total(node->right)),
+            left);
+        node = node->left;
+      }
+    }
+    aggregate_type right = Monoid::identity();
+    for (node_type* node = split->right; node;) {
+      if (this->compare_(node->key(), hi)) {
+        right = Monoid::combine(
+            right, Monoid::combine(augment::total(node->left),
+                                   Monoid::lift(node->values.second.value)));
+        node = node->right;
+      } else {
+        node = node->left;
+      }
+    }
+    return Monoid::combine(
+        Monoid::combine(left, Monoid::lift(split->values.second.value)),
+        right);
+  }
+
+ private:
+  // nullptr stands for end()
+  iterator make_iterator(node_type* node) const noexcept {
+    return iterator(
+        TreeIterator<Key, stored_type>(node ? node : this->end_, this->end_));
+  }
+};
+}  // namespace s21
+
+#endif  // S21_AUGMENTED_MAP_H_
@@ -3,17 +3,24 @@
 
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
-#include <vector>
+#include <tuple>
+#include <type_traits>
 
+#include "../frozen/frozen_map.h"
+#include "../mapped/mapped_format.h"
 #include "map_iterator.h"
 #include "tree_iterator.h"
 
 using std::out_of_range;
 
 namespace s21 {
-template <typename Key, typename T>
-class Map : public Tree<Key, T> {
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = pool_allocator<std::pair<const Key, T>>>
+class Map : public Tree<Key, T, Compare, Allocator> {
+  using tree_type = Tree<Key, T, Compare, Allocator>;
+
  public:
   using key_type = Key;
   using mapped_type = T;
@@ -22,35 +29,60 @@ class Map : public Tree<Key, T> {
   using const_reference = const value_type&;
   using iterator = MapIterator<Key, T>;
   using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using node_type = typename tree_type::node_type;
+  using insert_return_type = tree_insert_return_<iterator, node_type>;
 
   //  Map Member functions
-  Map() : Tree<Key, T>() {}
+  Map() : tree_type() {}
+
+  explicit Map(const Allocator& alloc) : tree_type(alloc) {}
+
+  explicit Map(const Compare& compare, const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {}
 
-  Map(std::initializer_list<value_type> const& items) : Tree<Key, T>(items) {}
+  Map(std::initializer_list<value_type> const& items,
+      const Compare& compare = Compare(), const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(items.begin(), items.end());
+  }
+
+  Map(std::initializer_list<value_type> const& items, const Allocator& alloc)
+      : Map(items, Compare(), alloc) {}
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  Map(InputIt first, InputIt last, const Compare& compare = Compare(),
+      const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(first, last);
+  }
 
-  Map(const Map& other) { *this = other; }
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  Map(InputIt first, InputIt last, const Allocator& alloc)
+      : Map(first, last, Compare(), alloc) {}
+
+  Map(const Map& other)
+      : tree_type(tree_type::node_traits::select_on_container_copy_construction(
+            other.node_allocator_)) {
+    *this = other;
+  }
 
   Map& operator=(const Map& other) {
-    this->clear();
-    auto e = other.end();
-    --e;
-    auto i = other.end();
-    do {
-      ++i;
-      this->insert_tree(*i);
-    } while (i != e);
+    this->copy_tree(other);
     return *this;
   }
 
-  Map(Map&& m) { *this = std::move(m); }
-
-  Map<Key, T>& operator=(Map&& m) {
-    this->clear();
-    this->root_ = m.root_;
-    this->end_ = m.end_;
+  Map(Map&& m) : tree_type(m.get_allocator()) { *this = std::move(m); }
 
-    m.root_ = nullptr;
-    m.end_ = nullptr;
+  Map& operator=(Map&& m) {
+    this->move_tree(m);
     return *this;
   }
 
@@ -58,185 +90,339 @@ class Map : public Tree<Key, T> {
 
   //  element access
   T& at(const Key& key) {
-    if (search(key) == nullptr) {
+    auto node = search(key);
+    if (node == nullptr) {
       throw std::out_of_range("No elements with such key");
     }
-    return search(key)->values.second;
+    return node->values.second;
   }
 
   T& operator[](const Key& key) {
-    if (search(key) == nullptr) {
-      return (*(insert({key, T()}).first)).second;
-    } else {
-      return search(key)->values.second;
-    }
+    return try_emplace_at(nullptr, key).first->values.second;
   }
 
   //  iterators
   MapIterator<Key, T> begin() const noexcept {
-    MapIterator<Key, T> iterator(this->end_->right);
-    return iterator;
+    return make_iterator(this->empty() ? nullptr : this->end_->right);
   }
 
-  MapIterator<Key, T> end() const noexcept {
-    MapIterator<Key, T> iterator(this->end_);
-    return iterator;
-  }
+  MapIterator<Key, T> end() const noexcept { return make_iterator(nullptr); }
 
   // capacity
   size_type max_size() const noexcept {
-    std::allocator<std::pair<Key, T>> Alloc;
-    return Alloc.max_size() / 9 * 5;
+    return tree_type::node_traits::max_size(this->node_allocator_);
   }
 
   //  modifiers
-  void erase(iterator pos) {
-    if (this->size() > 1) {
-      auto itb = ++begin();   //  ok
-      auto ite = -- --end();  //  ok
-      auto e = --end();
-      if (pos.iter == this->root_) {
-        if (this->root_->left) {
-          if (this->root_->right) {
-            this->insert_tree(this->root_->left, this->root_->right);
-          }
-          this->root_ = this->root_->left;
-        } else {
-          this->root_ = this->root_->right;
-        }
-        this->root_->parent = nullptr;
-        this->root_->color = Black;
-
-        if (pos == begin()) {
-          this->end_->right = itb.iter;
-        }
-        if (pos == e /* --end() */) {
-          this->end_->left = ite.iter;
-        }
-
-      } else {
-        if (pos == begin()) {
-          this->end_->right = itb.iter;
-        }
-        if (pos == e /* --end() */) {
-          this->end_->left = ite.iter;
-        }
-        if (pos.iter->parent->left && pos.iter->parent->left == pos.iter) {
-          pos.iter->parent->left = nullptr;
-        }
-        if (pos.iter->parent->right && pos.iter->parent->right == pos.iter) {
-          pos.iter->parent->right = nullptr;
-        }
-        if (pos.iter->left) {
-          this->insert_tree(this->root_, pos.iter->left);
-        }
-        if (pos.iter->right) {
-          this->insert_tree(this->root_, pos.iter->right);
-        }
-      }
-
-      delete pos.iter;
-
-      pos.iter = nullptr;
-
-    } else if (this->size() == 1) {
-      delete this->root_;
-      this->root_ = nullptr;
-      delete this->end_;
-      this->end_ = nullptr;
-    }
+  void erase(iterator pos) { this->erase_tree(pos.iter); }
+
+  void clear() { this->clear_tree(); }
+
+  // O(n) when the range is sorted and free of duplicates
+  void assign_sorted(std::initializer_list<value_type> const& items) {
+    assign_sorted(items.begin(), items.end());
   }
 
-  void clear() {
-    if (!this->empty()) {
-      if (this->size() > 1) {
-        auto i = begin();
-        auto e = end();
-        --e;
-        do {
-          i = begin();
-          erase(i);
-        } while (begin() != e);
-      }
-      delete this->root_;
-      delete this->end_;
-      this->root_ = nullptr;
-      this->end_ = nullptr;
-    }
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void assign_sorted(InputIt first, InputIt last) {
+    this->clear_tree();
+    this->insert_range_tree(first, last);
   }
 
   std::pair<iterator, bool> insert(const value_type& value) {
-    bool insertion = false;
-    if (search(value.first) == nullptr) {
-      this->insert_tree(value);
-      insertion = true;
-    }
-    return std::make_pair(iterator(search(value.first)), insertion);
+    auto inserted = this->insert_unique_tree(value);
+    return std::make_pair(make_iterator(inserted.first), inserted.second);
+  }
+
+  iterator insert(iterator hint, const value_type& value) {
+    return make_iterator(this->insert_unique_tree(hint.iter, value));
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_tree(first, last);
   }
 
   std::pair<iterator, bool> insert(const Key& key, const T& obj) {
-    std::pair<Key, T> value = {key, obj};
-    return insert(value);
+    auto inserted = this->emplace_key_tree(nullptr, key, key, obj);
+    return std::make_pair(make_iterator(inserted.first), inserted.second);
   }
 
   std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
-    std::pair<Key, T> value = {key, obj};
-    bool insertion = false;
-
-    if (search(value.first) == nullptr) {
-      this->insert_tree(value);
-      insertion = true;
-    } else {
-      (search(value.first))->values.second = value.second;
+    auto pos = this->find_insert_pos(key);
+    if (pos.node) {
+      pos.node->values.second = obj;
+      return std::make_pair(make_iterator(pos.node), false);
     }
-
-    return std::make_pair(iterator(search(value.first)), insertion);
+    return std::make_pair(
+        make_iterator(this->link_node(this->create_node(key, obj), pos)),
+        true);
   }
 
-  void swap(Map& other) {
-    std::swap(this->root_, other.root_);
-    std::swap(this->end_, other.end_);
+  void swap(Map& other) { this->swap_tree(other); }
+
+  // keys missing here move over, the rest stay in other; O(n + m)
+  void merge(Map& other) { this->merge_tree(other); }
+
+  //  node handles: move elements between trees without reallocating. The
+  //  node itself changes hands: pool_allocator containers take over each
+  //  other's blocks, other allocators have to compare equal, or the value
+  //  moves into a new node
+  node_type extract(iterator pos) { return this->extract_tree(pos.iter); }
+
+  // an empty handle when the key is missing
+  node_type extract(const Key& key) {
+    auto node = this->search_tree(this->root_, key);
+    return node ? this->extract_tree(node) : node_type();
   }
 
-  void merge(Map& other) {
-    auto e = other.end();
-    --e;
-    auto i = other.end();
-    ++i;
-    do {
-      if ((insert((*i).first, (*i).second)).second == true) {
-        other.erase(i);
-        i = other.begin();
-      } else {
-        ++i;
-      }
-    } while (i != e);
+  insert_return_type insert(node_type&& node) {
+    auto inserted = this->insert_node_tree(nullptr, node);
+    return insert_return_type{make_iterator(inserted.first), inserted.second,
+                              std::move(node)};
+  }
 
-    if ((insert((*i).first, (*i).second)).second == true) {
-      other.erase(i);
-    }
+  iterator insert(iterator hint, node_type&& node) {
+    return make_iterator(this->insert_node_tree(hint.iter, node).first);
   }
 
   //  lookup
-  bool contains(const Key& key) {
+  iterator find(const Key& key) const {
+    return make_iterator(this->search_tree(this->root_, key));
+  }
+
+  bool contains(const Key& key) const {
     return this->contains_tree(this->root_, key);
   }
 
+  size_type count(const Key& key) const { return this->count_tree(key); }
+
+  // O(log n); with repeated keys the range covers all of them
+  iterator lower_bound(const Key& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  // a transparent Compare looks up by any comparable K, no Key is built
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return make_iterator(this->search_tree(this->root_, key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return this->contains_tree(this->root_, key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return this->count_tree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  //  batched lookup
+  // one iterator per key of [first, last), end() for a miss; the descents
+  // of a batch run interleaved so their cache misses overlap
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    this->search_batch_tree(first, last,
+                            [this, &out](const auto&, tree_el_<Key, T>* node) {
+                              *out++ = make_iterator(node);
+                            });
+    return out;
+  }
+
+  template <typename Keys, typename OutputIt>
+  OutputIt find_many(const Keys& keys, OutputIt out) const {
+    return find_many(std::begin(keys), std::end(keys), out);
+  }
+
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt contains_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    this->search_batch_tree(first, last,
+                            [&out](const auto&, tree_el_<Key, T>* node) {
+                              *out++ = node != nullptr;
+                            });
+    return out;
+  }
+
+  template <typename Keys, typename OutputIt>
+  OutputIt contains_many(const Keys& keys, OutputIt out) const {
+    return contains_many(std::begin(keys), std::end(keys), out);
+  }
+
+  //  order statistics
+  iterator nth(size_type k) const noexcept {
+    auto node = this->nth_tree(k);
+    return make_iterator(node);
+  }
+
+  size_type rank(const Key& key) const {
+    return this->search_tree(this->root_, key) ? this->count_less_tree(key)
+                                               : this->size();
+  }
+
+  size_type count_less(const Key& key) const {
+    return this->count_less_tree(key);
+  }
+
+  // read-only copy in Eytzinger order for lookup-only workloads, O(n)
+  frozen_map<Key, T, Compare> freeze() const {
+    return frozen_map<Key, T, Compare>(sorted_unique, begin(), end(),
+                                       this->key_comp());
+  }
+
+  // binary image for mapped_map::open, trivially copyable types only;
+  // the file is written next to path and renamed over it
+  void save(const std::string& path) const {
+    save_mapped_image_<Key, T>(path, begin(), end(), this->size());
+  }
+
   // bonus
   template <typename... Args>
-  std::vector<std::pair<iterator, bool>> emplace(Args&&... args) {
-    std::vector<std::pair<iterator, bool>> out;
-    for (auto& i : {args...}) {
-      out.push_back(insert(i));
-    }
-    return out;
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    auto inserted = try_emplace_at(nullptr, key, std::forward<Args>(args)...);
+    return std::make_pair(make_iterator(inserted.first), inserted.second);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    auto inserted = try_emplace_at(nullptr, std::move(key),
+                                   std::forward<Args>(args)...);
+    return std::make_pair(make_iterator(inserted.first), inserted.second);
+  }
+
+  template <typename... Args>
+  iterator try_emplace(iterator hint, const Key& key, Args&&... args) {
+    return make_iterator(
+        try_emplace_at(hint.iter, key, std::forward<Args>(args)...).first);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    auto inserted = emplace_at(nullptr, std::forward<Args>(args)...);
+    return std::make_pair(make_iterator(inserted.first), inserted.second);
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(iterator hint, Args&&... args) {
+    return make_iterator(
+        emplace_at(hint.iter, std::forward<Args>(args)...).first);
   }
 
   // dop
+  // nullptr stands for end()
+  iterator make_iterator(tree_el_<Key, T>* node) const noexcept {
+    return iterator(node ? node : this->end_, this->end_);
+  }
+
   tree_el_<Key, T>* search(const Key& key) {
     return this->search_tree(this->root_, key);
   }
+
+  template <typename K, typename... Args>
+  std::pair<tree_el_<Key, T>*, bool> try_emplace_at(tree_el_<Key, T>* hint,
+                                                    K&& key, Args&&... args) {
+    return this->emplace_key_tree(
+        hint, key, std::piecewise_construct,
+        std::forward_as_tuple(std::forward<K>(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  // emplace(key, mapped) and emplace(pair) expose the key before construction
+  template <typename K, typename M,
+            typename = std::enable_if_t<std::is_same_v<std::decay_t<K>, Key>>>
+  std::pair<tree_el_<Key, T>*, bool> emplace_at(tree_el_<Key, T>* hint,
+                                                K&& key, M&& mapped) {
+    return this->emplace_key_tree(hint, key, std::forward<K>(key),
+                                  std::forward<M>(mapped));
+  }
+
+  template <typename P, typename = std::enable_if_t<std::is_same_v<
+                            std::decay_t<typename std::decay_t<P>::first_type>,
+                            Key>>>
+  std::pair<tree_el_<Key, T>*, bool> emplace_at(tree_el_<Key, T>* hint,
+                                                P&& value) {
+    return this->emplace_key_tree(hint, value.first, std::forward<P>(value));
+  }
+
+  template <typename... Args>
+  std::pair<tree_el_<Key, T>*, bool> emplace_at(tree_el_<Key, T>* hint,
+                                                Args&&... args) {
+    return this->emplace_unique_tree(hint, std::forward<Args>(args)...);
+  }
 };
+
+//  set algebra: one in-order walk over both trees, O(n + m)
+//  keys present in both take the element of a
+template <typename Key, typename T, typename Compare, typename Allocator>
+Map<Key, T, Compare, Allocator> set_union(
+    const Map<Key, T, Compare, Allocator>& a,
+    const Map<Key, T, Compare, Allocator>& b) {
+  Map<Key, T, Compare, Allocator> result(
+      a.key_comp(),
+      std::allocator_traits<Allocator>::select_on_container_copy_construction(
+          a.get_allocator()));
+  result.assign_set_operation_tree(a, b, true, true, true);
+  return result;
+}
+
+template <typename Key, typename T, typename Compare, typename Allocator>
+Map<Key, T, Compare, Allocator> set_intersection(
+    const Map<Key, T, Compare, Allocator>& a,
+    const Map<Key, T, Compare, Allocator>& b) {
+  Map<Key, T, Compare, Allocator> result(
+      a.key_comp(),
+      std::allocator_traits<Allocator>::select_on_container_copy_construction(
+          a.get_allocator()));
+  result.assign_set_operation_tree(a, b, false, true, false);
+  return result;
+}
+
+template <typename Key, typename T, typename Compare, typename Allocator>
+Map<Key, T, Compare, Allocator> set_difference(
+    const Map<Key, T, Compare, Allocator>& a,
+    const Map<Key, T, Compare, Allocator>& b) {
+  Map<Key, T, Compare, Allocator> result(
+      a.key_comp(),
+      std::allocator_traits<Allocator>::select_on_container_copy_construction(
+          a.get_allocator()));
+  result.assign_set_operation_tree(a, b, true, false, false);
+  return result;
+}
 }  // namespace s21
 
 #endif  // MAP_S21_MAP_H_
\ No newline at end of file
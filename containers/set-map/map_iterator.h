@@ -20,7 +20,8 @@ class MapIterator : public TreeIterator<Key, T> {
   // iterator's constructor
   MapIterator() : TreeIterator<Key, T>() {}
 
-  MapIterator(tree_el_<Key, T>* cur_iter) : TreeIterator<Key, T>(cur_iter) {}
+  MapIterator(tree_el_<Key, T>* cur_iter, tree_el_<Key, T>* end_iter = nullptr)
+      : TreeIterator<Key, T>(cur_iter, end_iter) {}
 };
 }  // namespace s21
 
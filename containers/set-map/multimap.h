@@ -0,0 +1,255 @@
+#ifndef S21_MULTIMAP_H_
+#define S21_MULTIMAP_H_
+
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "map_iterator.h"
+#include "tree_iterator.h"
+
+namespace s21 {
+// equal keys are kept in insertion order
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = pool_allocator<std::pair<const Key, T>>>
+class Multimap : public Tree<Key, T, Compare, Allocator> {
+  using tree_type = Tree<Key, T, Compare, Allocator>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = MapIterator<Key, T>;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using node_type = typename tree_type::node_type;
+
+  //  Multimap Member functions
+  Multimap() : tree_type() {}
+
+  explicit Multimap(const Allocator& alloc) : tree_type(alloc) {}
+
+  explicit Multimap(const Compare& compare,
+                    const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {}
+
+  Multimap(std::initializer_list<value_type> const& items,
+           const Compare& compare = Compare(),
+           const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(items.begin(), items.end(), false);
+  }
+
+  Multimap(std::initializer_list<value_type> const& items,
+           const Allocator& alloc)
+      : Multimap(items, Compare(), alloc) {}
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  Multimap(InputIt first, InputIt last, const Compare& compare = Compare(),
+           const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(first, last, false);
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  Multimap(InputIt first, InputIt last, const Allocator& alloc)
+      : Multimap(first, last, Compare(), alloc) {}
+
+  Multimap(const Multimap& other)
+      : tree_type(tree_type::node_traits::select_on_container_copy_construction(
+            other.node_allocator_)) {
+    *this = other;
+  }
+
+  Multimap& operator=(const Multimap& other) {
+    this->copy_tree(other);
+    return *this;
+  }
+
+  Multimap(Multimap&& m) : tree_type(m.get_allocator()) {
+    *this = std::move(m);
+  }
+
+  Multimap& operator=(Multimap&& m) {
+    this->move_tree(m);
+    return *this;
+  }
+
+  ~Multimap() { clear(); }
+
+  //  iterators
+  iterator begin() const noexcept {
+    return make_iterator(this->empty() ? nullptr : this->end_->right);
+  }
+
+  iterator end() const noexcept { return make_iterator(nullptr); }
+
+  // capacity
+  size_type max_size() const noexcept {
+    return tree_type::node_traits::max_size(this->node_allocator_);
+  }
+
+  //  modifiers
+  void erase(iterator pos) { this->erase_tree(pos.iter); }
+
+  // all elements with this key, returns how many were removed
+  size_type erase(const Key& key) {
+    size_type removed = 0;
+    for (auto node = this->lower_bound_tree(key);
+         node && !this->compare_(key, node->key()); ++removed) {
+      auto next = tree_type::next_tree(node);
+      this->erase_tree(node);
+      node = next;
+    }
+    return removed;
+  }
+
+  void clear() { this->clear_tree(); }
+
+  iterator insert(const value_type& value) {
+    return make_iterator(this->emplace_equal_tree(nullptr, value));
+  }
+
+  // as close before hint as the order allows
+  iterator insert(iterator hint, const value_type& value) {
+    return make_iterator(this->emplace_equal_tree(hint.iter, value));
+  }
+
+  iterator insert(const Key& key, const T& obj) {
+    return make_iterator(this->emplace_equal_tree(nullptr, key, obj));
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_tree(first, last, false);
+  }
+
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return make_iterator(
+        this->emplace_equal_tree(nullptr, std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(iterator hint, Args&&... args) {
+    return make_iterator(
+        this->emplace_equal_tree(hint.iter, std::forward<Args>(args)...));
+  }
+
+  void swap(Multimap& other) { this->swap_tree(other); }
+
+  // every element of other moves over, after our equal keys; O(n + m)
+  void merge(Multimap& other) { this->merge_tree(other, false); }
+
+  //  node handles: move elements between trees without reallocating. The
+  //  node itself changes hands: pool_allocator containers take over each
+  //  other's blocks, other allocators have to compare equal, or the value
+  //  moves into a new node
+  node_type extract(iterator pos) { return this->extract_tree(pos.iter); }
+
+  // the first element with this key, an empty handle when there is none
+  node_type extract(const Key& key) {
+    auto node = this->lower_bound_tree(key);
+    return node && !this->compare_(key, node->key()) ? this->extract_tree(node)
+                                                     : node_type();
+  }
+
+  iterator insert(node_type&& node) {
+    return make_iterator(this->insert_node_tree(nullptr, node, false).first);
+  }
+
+  iterator insert(iterator hint, node_type&& node) {
+    return make_iterator(this->insert_node_tree(hint.iter, node, false).first);
+  }
+
+  //  lookup: count and equal_range are O(log n) whatever the multiplicity
+  iterator find(const Key& key) const {
+    return make_iterator(this->search_tree_multiset(this->root_, key));
+  }
+
+  bool contains(const Key& key) const {
+    return this->contains_tree(this->root_, key);
+  }
+
+  size_type count(const Key& key) const { return this->count_tree(key); }
+
+  iterator lower_bound(const Key& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return make_iterator(this->search_tree_multiset(this->root_, key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return this->contains_tree(this->root_, key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return this->count_tree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  //  order statistics
+  iterator nth(size_type k) const noexcept {
+    return make_iterator(this->nth_tree(k));
+  }
+
+  size_type count_less(const Key& key) const {
+    return this->count_less_tree(key);
+  }
+
+  // dop
+  // nullptr stands for end()
+  iterator make_iterator(tree_el_<Key, T>* node) const noexcept {
+    return iterator(node ? node : this->end_, this->end_);
+  }
+};
+}  // namespace s21
+
+#endif  // S21_MULTIMAP_H_
@@ -0,0 +1,249 @@
+#ifndef S21_MULTISET_H_
+#define S21_MULTISET_H_
+
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "set_iterator.h"
+#include "tree_iterator.h"
+
+namespace s21 {
+// equal keys are kept in insertion order
+template <typename Key, typename Compare = std::less<Key>,
+          typename Allocator = pool_allocator<Key>>
+class Multiset : public Tree<Key, void, Compare, Allocator> {
+  using tree_type = Tree<Key, void, Compare, Allocator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = SetIterator<Key>;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using node_type = typename tree_type::node_type;
+
+  //  Multiset Member functions
+  Multiset() : tree_type() {}
+
+  explicit Multiset(const Allocator& alloc) : tree_type(alloc) {}
+
+  explicit Multiset(const Compare& compare,
+                    const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {}
+
+  Multiset(std::initializer_list<Key> const& items,
+           const Compare& compare = Compare(),
+           const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(items.begin(), items.end(), false);
+  }
+
+  Multiset(std::initializer_list<Key> const& items, const Allocator& alloc)
+      : Multiset(items, Compare(), alloc) {}
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  Multiset(InputIt first, InputIt last, const Compare& compare = Compare(),
+           const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(first, last, false);
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  Multiset(InputIt first, InputIt last, const Allocator& alloc)
+      : Multiset(first, last, Compare(), alloc) {}
+
+  Multiset(const Multiset& other)
+      : tree_type(tree_type::node_traits::select_on_container_copy_construction(
+            other.node_allocator_)) {
+    *this = other;
+  }
+
+  Multiset& operator=(const Multiset& other) {
+    this->copy_tree(other);
+    return *this;
+  }
+
+  Multiset(Multiset&& m) : tree_type(m.get_allocator()) {
+    *this = std::move(m);
+  }
+
+  Multiset& operator=(Multiset&& m) {
+    this->move_tree(m);
+    return *this;
+  }
+
+  ~Multiset() { clear(); }
+
+  //  iterators
+  iterator begin() const noexcept {
+    return make_iterator(this->empty() ? nullptr : this->end_->right);
+  }
+
+  iterator end() const noexcept { return make_iterator(nullptr); }
+
+  // capacity
+  size_type max_size() const noexcept {
+    return tree_type::node_traits::max_size(this->node_allocator_);
+  }
+
+  //  modifiers
+  void erase(iterator pos) { this->erase_tree(pos.iter); }
+
+  // all elements equal to key, returns how many were removed
+  size_type erase(const Key& key) {
+    size_type removed = 0;
+    for (auto node = this->lower_bound_tree(key);
+         node && !this->compare_(key, node->key()); ++removed) {
+      auto next = tree_type::next_tree(node);
+      this->erase_tree(node);
+      node = next;
+    }
+    return removed;
+  }
+
+  void clear() { this->clear_tree(); }
+
+  iterator insert(const Key& value) {
+    return make_iterator(this->emplace_equal_tree(nullptr, value));
+  }
+
+  // as close before hint as the order allows
+  iterator insert(iterator hint, const Key& value) {
+    return make_iterator(this->emplace_equal_tree(hint.iter, value));
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_tree(first, last, false);
+  }
+
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return make_iterator(
+        this->emplace_equal_tree(nullptr, std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(iterator hint, Args&&... args) {
+    return make_iterator(
+        this->emplace_equal_tree(hint.iter, std::forward<Args>(args)...));
+  }
+
+  void swap(Multiset& other) { this->swap_tree(other); }
+
+  // every element of other moves over, after our equal keys; O(n + m)
+  void merge(Multiset& other) { this->merge_tree(other, false); }
+
+  //  node handles: move elements between trees without reallocating. The
+  //  node itself changes hands: pool_allocator containers take over each
+  //  other's blocks, other allocators have to compare equal, or the value
+  //  moves into a new node
+  node_type extract(iterator pos) { return this->extract_tree(pos.iter); }
+
+  // the first element with this key, an empty handle when there is none
+  node_type extract(const Key& key) {
+    auto node = this->lower_bound_tree(key);
+    return node && !this->compare_(key, node->key()) ? this->extract_tree(node)
+                                                     : node_type();
+  }
+
+  iterator insert(node_type&& node) {
+    return make_iterator(this->insert_node_tree(nullptr, node, false).first);
+  }
+
+  iterator insert(iterator hint, node_type&& node) {
+    return make_iterator(this->insert_node_tree(hint.iter, node, false).first);
+  }
+
+  //  lookup: count and equal_range are O(log n) whatever the multiplicity
+  iterator find(const Key& key) const {
+    return make_iterator(this->search_tree_multiset(this->root_, key));
+  }
+
+  bool contains(const Key& key) const {
+    return this->contains_tree(this->root_, key);
+  }
+
+  size_type count(const Key& key) const { return this->count_tree(key); }
+
+  iterator lower_bound(const Key& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return make_iterator(this->search_tree_multiset(this->root_, key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return this->contains_tree(this->root_, key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return this->count_tree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  //  order statistics
+  iterator nth(size_type k) const noexcept {
+    return make_iterator(this->nth_tree(k));
+  }
+
+  size_type count_less(const Key& key) const {
+    return this->count_less_tree(key);
+  }
+
+  // dop
+  // nullptr stands for end()
+  iterator make_iterator(tree_el_<Key, void>* node) const noexcept {
+    return iterator(node ? node : this->end_, this->end_);
+  }
+};
+}  // namespace s21
+
+#endif  // S21_MULTISET_H_
@@ -3,224 +3,348 @@
 
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
-#include <vector>
+#include <type_traits>
 
+#include "../frozen/frozen_set.h"
+#include "../mapped/mapped_format.h"
 #include "set_iterator.h"
 #include "tree_iterator.h"
 
 using std::out_of_range;
 
 namespace s21 {
-template <typename Key, typename T = int>
-class Set : public Tree<Key, T> {
+template <typename Key, typename Compare = std::less<Key>,
+          typename Allocator = pool_allocator<Key>>
+class Set : public Tree<Key, void, Compare, Allocator> {
+  using tree_type = Tree<Key, void, Compare, Allocator>;
+
  public:
   using key_type = Key;
   using value_type = Key;
   using reference = value_type&;
   using const_reference = const value_type&;
-  using iterator = SetIterator<Key, T>;
+  using iterator = SetIterator<Key>;
   using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using node_type = typename tree_type::node_type;
+  using insert_return_type = tree_insert_return_<iterator, node_type>;
 
   //  Set Member functions
-  Set() : Tree<Key, T>() {}
+  Set() : tree_type() {}
+
+  explicit Set(const Allocator& alloc) : tree_type(alloc) {}
+
+  explicit Set(const Compare& compare, const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {}
+
+  Set(std::initializer_list<Key> const& items,
+      const Compare& compare = Compare(), const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(items.begin(), items.end());
+  }
 
-  Set(std::initializer_list<Key> const& items) {
-    this->root_ = nullptr;
-    this->end_ = nullptr;
-    for (auto i = items.begin(); i != items.end(); ++i) {
-      this->insert_tree(*i);
-    }
+  Set(std::initializer_list<Key> const& items, const Allocator& alloc)
+      : Set(items, Compare(), alloc) {}
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  Set(InputIt first, InputIt last, const Compare& compare = Compare(),
+      const Allocator& alloc = Allocator())
+      : tree_type(compare, alloc) {
+    this->insert_range_tree(first, last);
   }
 
-  Set(const Set& other) { *this = other; }
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  Set(InputIt first, InputIt last, const Allocator& alloc)
+      : Set(first, last, Compare(), alloc) {}
+
+  Set(const Set& other)
+      : tree_type(tree_type::node_traits::select_on_container_copy_construction(
+            other.node_allocator_)) {
+    *this = other;
+  }
 
   Set& operator=(const Set& other) {
-    this->clear();
-    auto e = other.end();
-    --e;
-    auto i = other.end();
-    do {
-      ++i;
-      this->insert_tree(*i);
-    } while (i != e);
+    this->copy_tree(other);
     return *this;
   }
 
-  Set(Set&& m) { *this = std::move(m); }
-
-  Set<Key, T>& operator=(Set&& m) {
-    this->clear();
-    this->root_ = m.root_;
-    this->end_ = m.end_;
+  Set(Set&& m) : tree_type(m.get_allocator()) { *this = std::move(m); }
 
-    m.root_ = nullptr;
-    m.end_ = nullptr;
+  Set& operator=(Set&& m) {
+    this->move_tree(m);
     return *this;
   }
 
   ~Set() { clear(); }
 
   //  iterators
-  SetIterator<Key, T> begin() const noexcept {
-    SetIterator<Key, T> iterator(this->end_->right);
-    return iterator;
+  SetIterator<Key> begin() const noexcept {
+    return make_iterator(this->empty() ? nullptr : this->end_->right);
   }
 
-  SetIterator<Key, T> end() const noexcept {
-    SetIterator<Key, T> iterator(this->end_);
-    return iterator;
-  }
+  SetIterator<Key> end() const noexcept { return make_iterator(nullptr); }
 
   // capacity
   size_type max_size() const noexcept {
-    std::allocator<std::pair<Key, T>> Alloc;
-    return Alloc.max_size() / 8 * 5 + 1;
+    return tree_type::node_traits::max_size(this->node_allocator_);
   }
 
   //  modifiers
-  void erase(iterator pos) {
-    if (this->size() > 1) {
-      auto itb = ++begin();
-      auto ite = -- --end();
-      auto e = --end();
-      if (pos.iter == this->root_) {
-        if (this->root_->left) {
-          if (this->root_->right) {
-            this->insert_tree(this->root_->left, this->root_->right);
-          }
-          this->root_ = this->root_->left;
-        } else {
-          this->root_ = this->root_->right;
-        }
-        this->root_->parent = nullptr;
-        this->root_->color = Black;
-
-        if (pos == begin()) {
-          this->end_->right = itb.iter;
-        }
-        if (pos == e /* --end() */) {
-          this->end_->left = ite.iter;
-        }
-
-      } else {
-        if (pos == begin()) {
-          this->end_->right = itb.iter;
-        }
-        if (pos == e /* --end() */) {
-          this->end_->left = ite.iter;
-        }
-        if (pos.iter->parent->left && pos.iter->parent->left == pos.iter) {
-          pos.iter->parent->left = nullptr;
-        }
-        if (pos.iter->parent->right && pos.iter->parent->right == pos.iter) {
-          pos.iter->parent->right = nullptr;
-        }
-        if (pos.iter->left) {
-          this->insert_tree(this->root_, pos.iter->left);
-        }
-        if (pos.iter->right) {
-          this->insert_tree(this->root_, pos.iter->right);
-        }
-      }
-
-      if (pos.iter) {
-        delete pos.iter;
-      }
-
-      pos.iter = nullptr;
-
-    } else if (this->size() == 1) {
-      delete this->root_;
-      this->root_ = nullptr;
-      delete this->end_;
-      this->end_ = nullptr;
-    }
-  }
-
-  void clear() {
-    if (!this->empty()) {
-      if (this->size() > 1) {
-        auto i = begin();
-        auto e = end();
-        --e;
-        do {
-          i = begin();
-          erase(i);
-        } while (begin() != e);
-      }
-      delete this->root_;
-      delete this->end_;
-      this->root_ = nullptr;
-      this->end_ = nullptr;
-    }
+  void erase(iterator pos) { this->erase_tree(pos.iter); }
+
+  void clear() { this->clear_tree(); }
+
+  // O(n) when the range is sorted and free of duplicates
+  void assign_sorted(std::initializer_list<Key> const& items) {
+    assign_sorted(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void assign_sorted(InputIt first, InputIt last) {
+    this->clear_tree();
+    this->insert_range_tree(first, last);
   }
 
   std::pair<iterator, bool> insert(const Key& value) {
-    bool insertion = false;
-    if (search(value) == nullptr) {
-      this->insert_tree(value);
-      insertion = true;
-    }
-    return std::make_pair(iterator(search(value)), insertion);
-  }
-
-  void swap(Set& other) {
-    std::swap(this->root_, other.root_);
-    std::swap(this->end_, other.end_);
-  }
-
-  void merge(Set& other) {
-    auto e = other.end();
-    --e;
-    auto i = other.end();
-    ++i;
-    do {
-      if ((insert(*i)).second == true) {
-        other.erase(i);
-        i = other.begin();
-      } else {
-        ++i;
-      }
-    } while (i != e);
-
-    if ((insert(*i)).second == true) {
-      other.erase(i);
-    }
+    auto inserted = this->insert_unique_tree(value);
+    return std::make_pair(make_iterator(inserted.first), inserted.second);
+  }
+
+  iterator insert(iterator hint, const Key& value) {
+    return make_iterator(this->insert_unique_tree(hint.iter, value));
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    this->insert_range_tree(first, last);
+  }
+
+  void swap(Set& other) { this->swap_tree(other); }
+
+  // keys missing here move over, the rest stay in other; O(n + m)
+  void merge(Set& other) { this->merge_tree(other); }
+
+  //  node handles: move elements between trees without reallocating. The
+  //  node itself changes hands: pool_allocator containers take over each
+  //  other's blocks, other allocators have to compare equal, or the value
+  //  moves into a new node
+  node_type extract(iterator pos) { return this->extract_tree(pos.iter); }
+
+  // an empty handle when the key is missing
+  node_type extract(const Key& key) {
+    auto node = this->search_tree(this->root_, key);
+    return node ? this->extract_tree(node) : node_type();
+  }
+
+  insert_return_type insert(node_type&& node) {
+    auto inserted = this->insert_node_tree(nullptr, node);
+    return insert_return_type{make_iterator(inserted.first), inserted.second,
+                              std::move(node)};
+  }
+
+  iterator insert(iterator hint, node_type&& node) {
+    return make_iterator(this->insert_node_tree(hint.iter, node).first);
   }
 
   //  lookup
-  iterator find(const Key& key) {
-    return iterator(this->search_tree(this->root_, key));
+  iterator find(const Key& key) const {
+    return make_iterator(this->search_tree(this->root_, key));
+  }
+
+  bool contains(const Key& key) const {
+    return this->contains_tree(this->root_, key);
+  }
+
+  size_type count(const Key& key) const { return this->count_tree(key); }
+
+  // O(log n); with repeated keys the range covers all of them
+  iterator lower_bound(const Key& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  // a transparent Compare looks up by any comparable K, no Key is built
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) const {
+    return make_iterator(this->search_tree(this->root_, key));
   }
 
-  bool contains(const Key& key) {
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
     return this->contains_tree(this->root_, key);
   }
 
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return this->count_tree(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return make_iterator(this->lower_bound_tree(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return make_iterator(this->upper_bound_tree(key));
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  //  batched lookup
+  // one bool per key of [first, last); the descents of a batch run
+  // interleaved so their cache misses overlap
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt contains_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    this->search_batch_tree(first, last,
+                            [&out](const auto&, tree_el_<Key, void>* node) {
+                              *out++ = node != nullptr;
+                            });
+    return out;
+  }
+
+  template <typename Keys, typename OutputIt>
+  OutputIt contains_many(const Keys& keys, OutputIt out) const {
+    return contains_many(std::begin(keys), std::end(keys), out);
+  }
+
+  //  order statistics
+  iterator nth(size_type k) const noexcept {
+    auto node = this->nth_tree(k);
+    return make_iterator(node);
+  }
+
+  size_type rank(const Key& key) const {
+    return this->search_tree(this->root_, key) ? this->count_less_tree(key)
+                                               : this->size();
+  }
+
+  size_type count_less(const Key& key) const {
+    return this->count_less_tree(key);
+  }
+
+  // read-only copy in Eytzinger order for lookup-only workloads, O(n)
+  frozen_set<Key, Compare> freeze() const {
+    return frozen_set<Key, Compare>(sorted_unique, begin(), end(),
+                                    this->key_comp());
+  }
+
+  // binary image for mapped_set::open, trivially copyable types only;
+  // the file is written next to path and renamed over it
+  void save(const std::string& path) const {
+    save_mapped_image_<Key, void>(path, begin(), end(), this->size());
+  }
+
   // // bonus
   template <typename... Args>
-  std::vector<std::pair<iterator, bool>> emplace(Args&&... args) {
-    std::vector<std::pair<iterator, bool>> out;
-    for (auto& i : {args...}) {
-      out.push_back(insert(i));
-    }
-    return out;
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    auto inserted = emplace_at(nullptr, std::forward<Args>(args)...);
+    return std::make_pair(make_iterator(inserted.first), inserted.second);
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(iterator hint, Args&&... args) {
+    return make_iterator(
+        emplace_at(hint.iter, std::forward<Args>(args)...).first);
   }
 
   // dop
-  tree_el_<Key, T>* search(const Key& key) {
+  // nullptr stands for end()
+  iterator make_iterator(tree_el_<Key, void>* node) const noexcept {
+    return iterator(node ? node : this->end_, this->end_);
+  }
+
+  tree_el_<Key, void>* search(const Key& key) {
     return this->search_tree(this->root_, key);
   }
 
-  tree_el_<Key, T>* search_multiset(const Key& key) {
-    return this->search_tree_multiset(this->root_, key);
+  // a ready key is looked up before anything is constructed
+  template <typename K,
+            typename = std::enable_if_t<std::is_same_v<std::decay_t<K>, Key>>>
+  std::pair<tree_el_<Key, void>*, bool> emplace_at(tree_el_<Key, void>* hint,
+                                                   K&& key) {
+    return this->emplace_key_tree(hint, key, std::forward<K>(key));
   }
 
-  Key upper_bound_multiset(const Key& key) {
-    return this->upper_bound_tree_multiset(this->root_, key);
+  template <typename... Args>
+  std::pair<tree_el_<Key, void>*, bool> emplace_at(tree_el_<Key, void>* hint,
+                                                   Args&&... args) {
+    return this->emplace_unique_tree(hint, std::forward<Args>(args)...);
   }
+
+  tree_el_<Key, void>* search_multiset(const Key& key) {
+    return this->search_tree_multiset(this->root_, key);
+  }
+
 };
+
+//  set algebra: one in-order walk over both trees, O(n + m)
+template <typename Key, typename Compare, typename Allocator>
+Set<Key, Compare, Allocator> set_union(
+    const Set<Key, Compare, Allocator>& a,
+    const Set<Key, Compare, Allocator>& b) {
+  Set<Key, Compare, Allocator> result(
+      a.key_comp(),
+      std::allocator_traits<Allocator>::select_on_container_copy_construction(
+          a.get_allocator()));
+  result.assign_set_operation_tree(a, b, true, true, true);
+  return result;
+}
+
+template <typename Key, typename Compare, typename Allocator>
+Set<Key, Compare, Allocator> set_intersection(
+    const Set<Key, Compare, Allocator>& a,
+    const Set<Key, Compare, Allocator>& b) {
+  Set<Key, Compare, Allocator> result(
+      a.key_comp(),
+      std::allocator_traits<Allocator>::select_on_container_copy_construction(
+          a.get_allocator()));
+  result.assign_set_operation_tree(a, b, false, true, false);
+  return result;
+}
+
+template <typename Key, typename Compare, typename Allocator>
+Set<Key, Compare, Allocator> set_difference(
+    const Set<Key, Compare, Allocator>& a,
+    const Set<Key, Compare, Allocator>& b) {
+  Set<Key, Compare, Allocator> result(
+      a.key_comp(),
+      std::allocator_traits<Allocator>::select_on_container_copy_construction(
+          a.get_allocator()));
+  result.assign_set_operation_tree(a, b, true, false, false);
+  return result;
+}
 }  // namespace s21
 
 #endif  // S21_SET_H_
\ No newline at end of file
@@ -11,16 +11,18 @@
 using std::out_of_range;
 
 namespace s21 {
-template <typename Key, typename T = int>
-class SetIterator : public TreeIterator<Key, T> {
+template <typename Key>
+class SetIterator : public TreeIterator<Key, void> {
  public:
   // iterator's operator
-  Key& operator*() { return this->iter->values.first; }
+  Key& operator*() { return this->iter->values; }
 
   // iterator's constructor
-  SetIterator() : TreeIterator<Key, T>() {}
+  SetIterator() : TreeIterator<Key, void>() {}
 
-  SetIterator(tree_el_<Key, T>* cur_iter) : TreeIterator<Key, T>(cur_iter) {}
+  SetIterator(tree_el_<Key, void>* cur_iter,
+              tree_el_<Key, void>* end_iter = nullptr)
+      : TreeIterator<Key, void>(cur_iter, end_iter) {}
 };
 }  // namespace s21
 
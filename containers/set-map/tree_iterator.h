@@ -15,66 +15,72 @@ template <typename Key, typename T>
 class tree_end_el_;
 template <typename Key, typename T>
 class tree_el_;
-template <typename Key, typename T>
+template <typename Key, typename T, typename Compare, typename Allocator>
 class Tree;
 
 template <typename Key, typename T>
 class TreeIterator {
  public:
   tree_el_<Key, T> *iter;
+  // sentinel of the owning tree: past the max, ++ and -- wrap through it
+  tree_el_<Key, T> *end;
 
   // constructor
-  TreeIterator() : iter(nullptr) {}
-  TreeIterator(tree_el_<Key, T> *cur_iter) : iter(cur_iter) {}
+  TreeIterator() : iter(nullptr), end(nullptr) {}
+  TreeIterator(tree_el_<Key, T> *cur_iter, tree_el_<Key, T> *end_iter = nullptr)
+      : iter(cur_iter), end(end_iter) {}
 
   // iterator's operators
-  bool operator==(const TreeIterator<Key, T> &other_iter) {
+  bool operator==(const TreeIterator<Key, T> &other_iter) const {
     return iter == other_iter.iter;
   }
 
-  bool operator!=(const TreeIterator<Key, T> &other_iter) {
+  bool operator!=(const TreeIterator<Key, T> &other_iter) const {
     return iter != other_iter.iter;
   }
 
   TreeIterator<Key, T> &operator++() {
-    if (iter->right) {
-      if (iter->right->left) {
-        iter = iter->right->left;
-        while (iter->left) {
-          iter = iter->left;
-        };
-      } else {
-        iter = iter->right;
+#ifdef S21_THREADED_TREE
+    if (end) {
+      iter = iter->next;
+      return *this;
+    }
+#endif
+    if (iter == end) {
+      iter = end->right;
+    } else if (iter->right) {
+      iter = iter->right;
+      while (iter->left) {
+        iter = iter->left;
       }
-    } else if (iter->parent && iter == iter->parent->left) {
-      iter = iter->parent;
-    } else if (iter->parent && iter == iter->parent->right) {
-      while (iter->parent && iter->parent->parent &&
-             iter->parent == iter->parent->parent->right) {
+    } else {
+      while (iter->parent && iter == iter->parent->right) {
         iter = iter->parent;
       }
-      iter = iter->parent->parent;
+      iter = iter->parent ? iter->parent : end;
     }
     return *this;
   }
 
   TreeIterator<Key, T> &operator--() {
-    if (iter->left) {
-      if (iter->left->right) {
-        iter = iter->left->right;
-        while (iter->right) {
-          iter = iter->right;
-        };
-      } else {
-        iter = iter->left;
+#ifdef S21_THREADED_TREE
+    if (end) {
+      iter = iter->prev;
+      return *this;
+    }
+#endif
+    if (iter == end) {
+      iter = end->left;
+    } else if (iter->left) {
+      iter = iter->left;
+      while (iter->right) {
+        iter = iter->right;
       }
-    } else if (iter->parent && iter == iter->parent->right) {
-      iter = iter->parent;
-    } else if (iter->parent && iter == iter->parent->left) {
-      while (iter->parent && iter->parent->parent &&
-             iter->parent == iter->parent->parent->right) {
-        iter = iter->parent->parent;
+    } else {
+      while (iter->parent && iter == iter->parent->left) {
+        iter = iter->parent;
       }
+      iter = iter->parent ? iter->parent : end;
     }
     return *this;
   }
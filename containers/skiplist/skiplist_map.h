@@ -0,0 +1,761 @@
+#ifndef S21_SKIPLIST_MAP_H_
+#define S21_SKIPLIST_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../utils/defines.h"
+
+namespace s21 {
+/*
+ * Политика высоты узла: каждый следующий уровень выпадает с вероятностью
+ * t_probability. Генератор xorshift свой у каждого потока
+ */
+class skiplist_geometric {
+ public:
+  explicit skiplist_geometric(double t_probability = 0.5) noexcept
+      : threshold_(t_probability >= 1.0
+                       ? UINT64_MAX
+                       : static_cast<std::uint64_t>(
+                             t_probability * static_cast<double>(UINT64_MAX))) {}
+
+  int operator()(int t_max_height) const noexcept {
+    thread_local std::uint64_t state =
+        0x9E3779B97F4A7C15ULL ^ reinterpret_cast<std::uintptr_t>(&state);
+    int height = 1;
+    while (height < t_max_height) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      if (state >= threshold_) break;
+      ++height;
+    }
+    return height;
+  }
+
+ private:
+  std::uint64_t threshold_;
+};
+
+/*
+ * Упорядоченный словарь на списке с пропусками. find, contains, count,
+ * lower_bound, upper_bound, at, insert, emplace и erase по ключу можно
+ * вызывать из разных потоков одновременно: читатели идут по указателям без
+ * блокировок, писатели вставляют и вырезают узлы через CAS. Удаление
+ * сначала помечает младший бит ссылок next удаляемого узла, физически
+ * узел вырезается следующим проходом любого писателя.
+ * Память вырезанных узлов возвращается по эпохам: каждая операция входит
+ * в эпоху через pin(), вырезанный узел помечается текущей эпохой и
+ * освобождается в reclaim(), когда эпоха ушла на два шага вперед - к этому
+ * моменту вышли все, кто мог его видеть. Эпоха сдвигается, только если
+ * счетчики читателей позапрошлой эпохи пусты, поэтому reclaim() никого не
+ * ждет. erase вызывает reclaim() каждые SKIPLIST_RECLAIM_BATCH удалений.
+ * Итератор и ссылка, полученные под pin(), живут, пока жив guard; без него
+ * элемент, удаленный другим потоком, может быть освобожден. Остальные
+ * операции, включая обход итераторами без pin() и изменение значений,
+ * требуют внешней синхронизации
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename LevelPolicy = skiplist_geometric,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class skiplist_map {
+  using link_type = std::atomic<std::uintptr_t>;
+
+  struct node {
+    std::pair<const Key, T> values;
+    int height;
+    // вставка, поднимающая узел по уровням, и удаление: освобождает
+    // последний из двух, так поздняя вставка уровня не оставит ссылку
+    std::atomic<int> owners{2};
+    std::uint64_t retired_epoch = 0;
+    node* retired_next = nullptr;
+
+    template <typename... Args>
+    explicit node(int t_height, Args&&... t_args)
+        : values(std::forward<Args>(t_args)...), height(t_height) {}
+
+    // ссылки по уровням лежат сразу за узлом в том же блоке
+    link_type* next() noexcept {
+      return reinterpret_cast<link_type*>(reinterpret_cast<char*>(this) +
+                                          sizeof(node));
+    }
+  };
+
+  using node_allocator_type = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator_type>;
+  using link_allocator_type = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<link_type>;
+  using link_traits = std::allocator_traits<link_allocator_type>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = skiplist_map::value_type;
+    using pointer = value_type*;
+    using reference = value_type&;
+
+    iterator() = default;
+    explicit iterator(node* t_node) : node_(t_node) {}
+
+    reference operator*() const { return node_->values; }
+
+    pointer operator->() const { return std::addressof(node_->values); }
+
+    iterator& operator++() {
+      node_ = skiplist_map::next_alive(node_->next()[0]);
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator& t_other) const {
+      return node_ == t_other.node_;
+    }
+
+    bool operator!=(const iterator& t_other) const {
+      return node_ != t_other.node_;
+    }
+
+   private:
+    friend class skiplist_map;
+
+    node* node_ = nullptr;
+  };
+
+  // while a guard lives, nodes its thread may have seen are not freed
+  class read_guard {
+   public:
+    read_guard(read_guard&& other) noexcept
+        : slot_(std::exchange(other.slot_, nullptr)) {}
+    read_guard(const read_guard&) = delete;
+    read_guard& operator=(const read_guard&) = delete;
+    read_guard& operator=(read_guard&&) = delete;
+
+    ~read_guard() {
+      if (slot_) slot_->fetch_sub(1, std::memory_order_release);
+    }
+
+   private:
+    friend class skiplist_map;
+
+    explicit read_guard(std::atomic<std::size_t>* t_slot) noexcept
+        : slot_(t_slot) {}
+
+    std::atomic<std::size_t>* slot_;
+  };
+
+  //  skiplist_map Member functions
+  skiplist_map() : skiplist_map(defines::SKIPLIST_MAX_HEIGHT) {}
+
+  explicit skiplist_map(int max_height,
+                        const LevelPolicy& policy = LevelPolicy(),
+                        const Compare& compare = Compare(),
+                        const Allocator& alloc = Allocator())
+      : max_height_(max_height < 1            ? 1
+                    : max_height > kMaxLevels ? kMaxLevels
+                                              : max_height),
+        policy_(policy),
+        compare_(compare),
+        node_allocator_(alloc),
+        link_allocator_(alloc) {
+    head_ = link_traits::allocate(link_allocator_, max_height_);
+    for (int level = 0; level < max_height_; ++level) {
+      new (head_ + level) link_type(0);
+    }
+  }
+
+  explicit skiplist_map(const Compare& compare,
+                        const Allocator& alloc = Allocator())
+      : skiplist_map(defines::SKIPLIST_MAX_HEIGHT, LevelPolicy(), compare,
+                     alloc) {}
+
+  skiplist_map(std::initializer_list<value_type> const& items,
+               const Compare& compare = Compare())
+      : skiplist_map(compare) {
+    insert(items.begin(), items.end());
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  skiplist_map(InputIt first, InputIt last,
+               const Compare& compare = Compare())
+      : skiplist_map(compare) {
+    insert(first, last);
+  }
+
+  skiplist_map(const skiplist_map& other)
+      : skiplist_map(other.max_height_, other.policy_, other.compare_,
+                     std::allocator_traits<Allocator>::
+                         select_on_container_copy_construction(
+                             Allocator(other.node_allocator_))) {
+    insert(other.begin(), other.end());
+  }
+
+  skiplist_map(skiplist_map&& other)
+      : skiplist_map(other.max_height_, other.policy_, other.compare_,
+                     Allocator(other.node_allocator_)) {
+    swap(other);
+  }
+
+  skiplist_map& operator=(const skiplist_map& other) {
+    if (this != &other) {
+      skiplist_map copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  skiplist_map& operator=(skiplist_map&& other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~skiplist_map() {
+    clear();
+    link_traits::deallocate(link_allocator_, head_, max_height_);
+  }
+
+  allocator_type get_allocator() const {
+    return allocator_type(node_allocator_);
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+  //  element access
+  T& at(const Key& key) {
+    read_guard guard = pin();
+    iterator it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("No elements with such key");
+    }
+    return it->second;
+  }
+
+  T& operator[](const Key& key) {
+    read_guard guard = pin();
+    return try_emplace(key).first->second;
+  }
+
+  //  iterators
+  iterator begin() const noexcept { return iterator(next_alive(head_[0])); }
+
+  iterator end() const noexcept { return iterator(nullptr); }
+
+  //  capacity
+  bool empty() const noexcept { return size() == 0; }
+
+  size_type size() const noexcept {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  size_type max_size() const noexcept {
+    return node_traits::max_size(node_allocator_);
+  }
+
+  //  modifiers
+  // not safe against concurrent use: frees every node, unlinked ones too
+  void clear() noexcept {
+    node* current = unmarked(head_[0].load(std::memory_order_relaxed));
+    while (current) {
+      node* next = unmarked(current->next()[0].load(std::memory_order_relaxed));
+      if (!marked(current->next()[0].load(std::memory_order_relaxed))) {
+        destroy_node(current);
+      }
+      current = next;
+    }
+    // помеченные узлы выше пропущены: они уже в retired_ или limbo_
+    free_retired();
+    for (int level = 0; level < max_height_; ++level) {
+      head_[level].store(0, std::memory_order_relaxed);
+    }
+    size_.store(0, std::memory_order_relaxed);
+    height_.store(defines::DEFAULT_HEIGHT, std::memory_order_relaxed);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return emplace_key(value.first, value);
+  }
+
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return emplace_key(key, key, obj);
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category,
+                std::input_iterator_tag>::value>>
+  void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      emplace_key((*first).first, (*first).first, (*first).second);
+    }
+  }
+
+  // the assignment itself is not atomic, see the class comment
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
+    read_guard guard = pin();
+    auto inserted = emplace_key(key, key, obj);
+    if (!inserted.second) inserted.first->second = obj;
+    return inserted;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return emplace_key(key, std::piecewise_construct,
+                       std::forward_as_tuple(key),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename K, typename M>
+  std::pair<iterator, bool> emplace(K&& key, M&& mapped) {
+    return emplace_key(key, std::forward<K>(key), std::forward<M>(mapped));
+  }
+
+  void erase(iterator pos) { erase(pos->first); }
+
+  size_type erase(const Key& key) {
+    {
+      read_guard guard = pin();
+      link_type* preds[kMaxLevels];
+      node* succs[kMaxLevels];
+      if (!find_for_update(key, preds, succs)) return 0;
+      node* victim = succs[0];
+      // верхние уровни помечаются сверху вниз, решает пометка уровня 0
+      for (int level = victim->height - 1; level > 0; --level) {
+        mark(victim->next()[level]);
+      }
+      link_type& bottom = victim->next()[0];
+      std::uintptr_t succ = bottom.load(std::memory_order_acquire);
+      while (true) {
+        if (marked(succ)) return 0;
+        if (bottom.compare_exchange_weak(succ, succ | 1,
+                                         std::memory_order_acq_rel)) {
+          break;
+        }
+      }
+      // повторный проход вырезает помеченный узел со всех уровней
+      find_for_update(key, preds, succs);
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      release(victim);
+    }
+    if (erased_.fetch_add(1, std::memory_order_relaxed) %
+            defines::SKIPLIST_RECLAIM_BATCH ==
+        defines::SKIPLIST_RECLAIM_BATCH - 1) {
+      reclaim();
+    }
+    return 1;
+  }
+
+  // pins the current epoch for this thread, see the class comment
+  read_guard pin() const noexcept {
+    const std::size_t stripe = reader_stripe();
+    while (true) {
+      std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+      std::atomic<std::size_t>& slot = readers_[epoch & 1][stripe].active;
+      slot.fetch_add(1, std::memory_order_seq_cst);
+      // эпоха сдвинулась между чтением и входом: вход засчитан не туда
+      if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+        return read_guard(&slot);
+      }
+      slot.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  // frees erased nodes that no pinned thread can still reach; never waits,
+  // a concurrent call just returns
+  void reclaim() {
+    std::unique_lock<std::mutex> lock(reclaim_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+    advance_epoch();
+    for (node* incoming = retired_.exchange(nullptr, std::memory_order_acq_rel);
+         incoming;) {
+      node* next = incoming->retired_next;
+      incoming->retired_next = limbo_;
+      limbo_ = incoming;
+      incoming = next;
+    }
+    const std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+    for (node** link = &limbo_; *link;) {
+      node* retired = *link;
+      if (retired->retired_epoch + 2 <= epoch) {
+        *link = retired->retired_next;
+        destroy_node(retired);
+      } else {
+        link = &retired->retired_next;
+      }
+    }
+  }
+
+  // not safe against concurrent use
+  void swap(skiplist_map& other) {
+    // эпохи у каждого словаря свои, вырезанные узлы не переезжают
+    free_retired();
+    other.free_retired();
+    std::swap(head_, other.head_);
+    std::swap(max_height_, other.max_height_);
+    std::swap(policy_, other.policy_);
+    std::swap(compare_, other.compare_);
+    std::swap(node_allocator_, other.node_allocator_);
+    std::swap(link_allocator_, other.link_allocator_);
+    size_type count = size_.exchange(other.size_.load());
+    other.size_.store(count);
+    int height = height_.exchange(other.height_.load());
+    other.height_.store(height);
+  }
+
+  // keys missing here move over, the rest stay in other
+  void merge(skiplist_map& other) {
+    for (iterator it = other.begin(); it != other.end();) {
+      const Key& key = it->first;
+      if (emplace_key(key, key, std::move_if_noexcept(it->second)).second) {
+        ++it;
+        other.erase(key);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  //  lookup
+  iterator find(const Key& key) const {
+    read_guard guard = pin();
+    node* found = seek(key, false);
+    if (found && !compare_(key, found->values.first)) return iterator(found);
+    return end();
+  }
+
+  bool contains(const Key& key) const { return find(key) != end(); }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key& key) const {
+    read_guard guard = pin();
+    return iterator(seek(key, false));
+  }
+
+  iterator upper_bound(const Key& key) const {
+    read_guard guard = pin();
+    return iterator(seek(key, true));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+ private:
+  static constexpr int kMaxLevels = 64;
+
+  struct alignas(64) reader_slot_ {
+    std::atomic<std::size_t> active{0};
+  };
+
+  // потоки раскладываются по полосам счетчиков, чтобы не делить кэш-линию
+  static std::size_t reader_stripe() noexcept {
+    static std::atomic<std::size_t> next_stripe{0};
+    thread_local std::size_t stripe =
+        next_stripe.fetch_add(1, std::memory_order_relaxed) %
+        defines::SKIPLIST_READER_STRIPES;
+    return stripe;
+  }
+
+  /*
+   * из эпохи e в e + 1 можно перейти, когда вышли все, кто вошел в e - 1:
+   * новые входы идут в четность e, а вошедшие раньше e - 1 вышли еще до
+   * прошлого сдвига. Узел с пометкой e освобождается в эпохе e + 2
+   */
+  void advance_epoch() noexcept {
+    const std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+    for (const reader_slot_& slot : readers_[(epoch + 1) & 1]) {
+      if (slot.active.load(std::memory_order_seq_cst) != 0) return;
+    }
+    epoch_.store(epoch + 1, std::memory_order_seq_cst);
+  }
+
+  // без конкурентного доступа: читателей нет, ждать нечего
+  void free_retired() noexcept {
+    for (node* retired = retired_.exchange(nullptr); retired;) {
+      node* next = retired->retired_next;
+      destroy_node(retired);
+      retired = next;
+    }
+    for (node* retired = std::exchange(limbo_, nullptr); retired;) {
+      node* next = retired->retired_next;
+      destroy_node(retired);
+      retired = next;
+    }
+  }
+
+  static node* unmarked(std::uintptr_t t_link) noexcept {
+    return reinterpret_cast<node*>(t_link & ~std::uintptr_t{1});
+  }
+
+  static bool marked(std::uintptr_t t_link) noexcept { return t_link & 1; }
+
+  static std::uintptr_t link_of(node* t_node) noexcept {
+    return reinterpret_cast<std::uintptr_t>(t_node);
+  }
+
+  static void mark(link_type& t_link) noexcept {
+    std::uintptr_t succ = t_link.load(std::memory_order_acquire);
+    while (!marked(succ) &&
+           !t_link.compare_exchange_weak(succ, succ | 1,
+                                         std::memory_order_acq_rel)) {
+    }
+  }
+
+  // первый живой узел, начиная со ссылки t_link
+  static node* next_alive(const link_type& t_link) noexcept {
+    node* current = unmarked(t_link.load(std::memory_order_acquire));
+    while (current &&
+           marked(current->next()[0].load(std::memory_order_acquire))) {
+      current = unmarked(current->next()[0].load(std::memory_order_acquire));
+    }
+    return current;
+  }
+
+  /*
+   * поиск читателя: помеченные узлы пропускаются, но не вырезаются, никаких
+   * записей в общую память. Возвращает первый живой узел с ключом не меньше
+   * t_key (больше t_key при t_upper)
+   */
+  node* seek(const Key& t_key, bool t_upper) const {
+    const link_type* pred = head_;
+    node* current = nullptr;
+    for (int level = height_.load(std::memory_order_acquire) - 1; level >= 0;
+         --level) {
+      current = unmarked(pred[level].load(std::memory_order_acquire));
+      while (current) {
+        std::uintptr_t succ =
+            current->next()[level].load(std::memory_order_acquire);
+        bool before = t_upper ? !compare_(t_key, current->values.first)
+                              : compare_(current->values.first, t_key);
+        if (!marked(succ) && !before) break;
+        if (!marked(succ)) pred = current->next();
+        current = unmarked(succ);
+      }
+    }
+    return current && marked(current->next()[0].load(std::memory_order_acquire))
+               ? next_alive(current->next()[0])
+               : current;
+  }
+
+  /*
+   * поиск писателя: для каждого уровня ниже height_ запоминает
+   * ссылку-предшественника и преемника, по пути вырезая помеченные узлы.
+   * Неудачный CAS означает, что предшественник сам удален, поиск
+   * начинается заново; так же и при росте height_ во время прохода. Выше
+   * height_ узлов нет: высота поднимается раньше, чем узел встает на
+   * верхние уровни. t_levels получает число пройденных уровней
+   */
+  bool find_for_update(const Key& t_key, link_type** t_preds, node** t_succs,
+                       int* t_levels = nullptr) {
+  retry:
+    const int height = height_.load(std::memory_order_acquire);
+    link_type* pred = head_;
+    node* current = nullptr;
+    for (int level = height - 1; level >= 0; --level) {
+      current = unmarked(pred[level].load(std::memory_order_acquire));
+      while (current) {
+        std::uintptr_t succ =
+            current->next()[level].load(std::memory_order_acquire);
+        while (marked(succ)) {
+          std::uintptr_t expected = link_of(current);
+          if (!pred[level].compare_exchange_strong(
+                  expected, succ & ~std::uintptr_t{1},
+                  std::memory_order_acq_rel)) {
+            goto retry;
+          }
+          current = unmarked(succ);
+          if (current == nullptr) break;
+          succ = current->next()[level].load(std::memory_order_acquire);
+        }
+        if (current == nullptr || !compare_(current->values.first, t_key)) {
+          break;
+        }
+        pred = current->next();
+        current = unmarked(succ);
+      }
+      t_preds[level] = pred + level;
+      t_succs[level] = current;
+    }
+    if (height_.load(std::memory_order_acquire) != height) goto retry;
+    if (t_levels) *t_levels = height;
+    return current && !compare_(t_key, current->values.first);
+  }
+
+  // уровни выше пройденных пусты: предшественник - голова
+  void fill_from_head(int t_from, int t_to, link_type** t_preds,
+                      node** t_succs) noexcept {
+    for (int level = t_from; level < t_to; ++level) {
+      t_preds[level] = head_ + level;
+      t_succs[level] = nullptr;
+    }
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_key(const Key& t_key, Args&&... t_args) {
+    read_guard guard = pin();
+    link_type* preds[kMaxLevels];
+    node* succs[kMaxLevels];
+    int levels = 0;
+    if (find_for_update(t_key, preds, succs, &levels)) {
+      return std::make_pair(iterator(succs[0]), false);
+    }
+    node* fresh = create_node(policy_(max_height_),
+                              std::forward<Args>(t_args)...);
+    const Key& key = fresh->values.first;
+    fill_from_head(levels, fresh->height, preds, succs);
+    while (true) {
+      for (int level = 0; level < fresh->height; ++level) {
+        fresh->next()[level].store(link_of(succs[level]),
+                                   std::memory_order_relaxed);
+      }
+      std::uintptr_t expected = link_of(succs[0]);
+      // узел становится видимым после CAS на уровне 0
+      if (preds[0]->compare_exchange_strong(expected, link_of(fresh),
+                                            std::memory_order_acq_rel)) {
+        break;
+      }
+      if (find_for_update(key, preds, succs, &levels)) {
+        destroy_node(fresh);
+        return std::make_pair(iterator(succs[0]), false);
+      }
+      fill_from_head(levels, fresh->height, preds, succs);
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+    raise_height(fresh->height);
+    link_upper_levels(fresh, preds, succs);
+    // удаление могло пройти, пока узел поднимался: снимаем поздние ссылки
+    if (marked(fresh->next()[0].load(std::memory_order_acquire))) {
+      find_for_update(key, preds, succs);
+    }
+    release(fresh);
+    return std::make_pair(iterator(fresh), true);
+  }
+
+  void link_upper_levels(node* t_node, link_type** t_preds, node** t_succs) {
+    const Key& key = t_node->values.first;
+    for (int level = 1; level < t_node->height; ++level) {
+      while (true) {
+        link_type& own = t_node->next()[level];
+        std::uintptr_t current = own.load(std::memory_order_acquire);
+        // узел уже удаляют: выше его не поднимаем
+        if (marked(current)) return;
+        if (unmarked(current) != t_succs[level] &&
+            !own.compare_exchange_strong(current, link_of(t_succs[level]),
+                                         std::memory_order_acq_rel)) {
+          return;
+        }
+        std::uintptr_t expected = link_of(t_succs[level]);
+        if (t_preds[level]->compare_exchange_strong(
+                expected, link_of(t_node), std::memory_order_acq_rel)) {
+          break;
+        }
+        find_for_update(key, t_preds, t_succs);
+        if (t_succs[0] != t_node) return;
+      }
+    }
+  }
+
+  void raise_height(int t_height) noexcept {
+    int height = height_.load(std::memory_order_relaxed);
+    while (height < t_height &&
+           !height_.compare_exchange_weak(height, t_height,
+                                          std::memory_order_acq_rel)) {
+    }
+  }
+
+  void release(node* t_node) noexcept {
+    if (t_node->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      retire(t_node);
+    }
+  }
+
+  // вырезанный узел ждет reclaim(): его еще могут читать
+  void retire(node* t_node) noexcept {
+    t_node->retired_epoch = epoch_.load(std::memory_order_seq_cst);
+    node* head = retired_.load(std::memory_order_relaxed);
+    do {
+      t_node->retired_next = head;
+    } while (!retired_.compare_exchange_weak(head, t_node,
+                                             std::memory_order_acq_rel));
+  }
+
+  static std::size_t units_for(int t_height) noexcept {
+    std::size_t bytes = sizeof(node) + t_height * sizeof(link_type);
+    return (bytes + sizeof(node) - 1) / sizeof(node);
+  }
+
+  template <typename... Args>
+  node* create_node(int t_height, Args&&... t_args) {
+    std::size_t units = units_for(t_height);
+    node* fresh = node_traits::allocate(node_allocator_, units);
+    try {
+      ::new (static_cast<void*>(fresh))
+          node(t_height, std::forward<Args>(t_args)...);
+    } catch (...) {
+      node_traits::deallocate(node_allocator_, fresh, units);
+      THROW_FURTHER;
+    }
+    for (int level = 0; level < t_height; ++level) {
+      ::new (static_cast<void*>(fresh->next() + level)) link_type(0);
+    }
+    return fresh;
+  }
+
+  void destroy_node(node* t_node) noexcept {
+    std::size_t units = units_for(t_node->height);
+    t_node->~node();
+    node_traits::deallocate(node_allocator_, t_node, units);
+  }
+
+  link_type* head_ = nullptr;
+  int max_height_;
+  std::atomic<int> height_{defines::DEFAULT_HEIGHT};
+  std::atomic<size_type> size_{0};
+  std::atomic<node*> retired_{nullptr};
+  std::atomic<std::uint64_t> epoch_{0};
+  std::atomic<size_type> erased_{0};
+  mutable reader_slot_ readers_[2][defines::SKIPLIST_READER_STRIPES];
+  // вырезанные узлы, забранные из retired_ и ждущие своей эпохи
+  node* limbo_ = nullptr;
+  std::mutex reclaim_mutex_;
+  LevelPolicy policy_;
+  Compare compare_;
+  node_allocator_type node_allocator_;
+  link_allocator_type link_allocator_;
+};
+}  // namespace s21
+
+#endif  // S21_SKIPLIST_MAP_H_
@@ -3,10 +3,16 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
 #include <deque>
+#include <iterator>
+#include <limits>
 #include <list>
+#include <memory>
 #include <queue>
 #include <stack>
+#include <string_view>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
@@ -102,6 +108,28 @@ TEST(VECTOR_FUNCTION_TESTS, METHOD_CLEAR_TEST) {
   ASSERT_EQ(vec.size(), static_cast<size_t>(0));
 }
 
+TEST(VECTOR_FUNCTION_TESTS, OWNING_ELEMENTS_TEST) {
+  vector<std::string> vec(0);
+  for (int i = 0; i < 20; ++i) {
+    vec.push_back(std::string(30, static_cast<char>('a' + i)));
+  }
+  vec.insert(vec.cbegin() + 3, std::string(40, 'z'));
+  vec.erase(vec.begin());
+  const vector<std::string> copy = vec;
+  vector<std::string> assigned;
+  assigned = copy;
+
+  ASSERT_EQ(copy.size(), static_cast<size_t>(20));
+  ASSERT_EQ(vec[2], std::string(40, 'z'));
+  ASSERT_EQ(assigned[2], vec[2]);
+  ASSERT_EQ(assigned[19], std::string(30, 't'));
+
+  vector<std::string> moved(std::move(vec));
+  vec.push_back("reused");
+  ASSERT_EQ(vec.size(), static_cast<size_t>(1));
+  ASSERT_EQ(moved[0], std::string(30, 'b'));
+}
+
 TEST(MapConstructor, Default) {
   s21::Map<std::string, int> s;
   std::map<std::string, int> b;
@@ -559,10 +587,11 @@ TEST(MapModifiers, Emplace) {
   EXPECT_EQ(s_tree.size(), o_tree.size());
   EXPECT_EQ(s_tree.empty(), o_tree.empty());
 
-  auto v = s_tree.emplace(std::pair<std::string, int>{"eleven", 11},
-                          std::pair<std::string, int>{"twelve", 12},
-                          std::pair<std::string, int>{"nine", 13},
-                          std::pair<std::string, int>{"thirteen", 13});
+  std::vector<std::pair<s21::Map<std::string, int>::iterator, bool>> v = {
+      s_tree.emplace(std::pair<std::string, int>{"eleven", 11}),
+      s_tree.emplace(std::string("twelve"), 12),
+      s_tree.emplace("nine", 13),
+      s_tree.emplace(std::pair<std::string, int>{"thirteen", 13})};
 
   auto p1 = o_tree.emplace("eleven", 11);
   auto p2 = o_tree.emplace("twelve", 12);
@@ -596,6 +625,1378 @@ TEST(MapModifiers, Emplace) {
   }
 }
 
+TEST(MapLookup, OrderStatistics) {
+  s21::Map<int, std::string> s_tree = {
+      {50, "fifty"}, {20, "twenty"}, {70, "seventy"}, {10, "ten"},
+      {40, "fourty"}, {60, "sixty"}, {30, "thirty"}};
+
+  EXPECT_EQ(s_tree.size(), 7U);
+  for (size_t k = 0; k < s_tree.size(); ++k) {
+    EXPECT_EQ((*s_tree.nth(k)).first, static_cast<int>(10 * (k + 1)));
+    EXPECT_EQ(s_tree.rank(static_cast<int>(10 * (k + 1))), k);
+  }
+  EXPECT_TRUE(s_tree.nth(7) == s_tree.end());
+  EXPECT_EQ(s_tree.rank(35), s_tree.size());
+
+  EXPECT_EQ(s_tree.count_less(5), 0U);
+  EXPECT_EQ(s_tree.count_less(10), 0U);
+  EXPECT_EQ(s_tree.count_less(35), 3U);
+  EXPECT_EQ(s_tree.count_less(100), 7U);
+
+  s_tree.erase(s_tree.nth(3));
+  EXPECT_EQ(s_tree.size(), 6U);
+  EXPECT_EQ((*s_tree.nth(3)).first, 50);
+  EXPECT_EQ(s_tree.count_less(45), 3U);
+}
+
+TEST(MapAllocator, StdAllocator) {
+  using alloc = std::allocator<std::pair<const int, std::string>>;
+  using map_type = s21::Map<int, std::string, std::less<int>, alloc>;
+  map_type s_tree = {
+      {10, "ten"}, {20, "twenty"}, {30, "thirty"}, {40, "fourty"}};
+
+  s_tree.insert(50, "fifty");
+  s_tree.erase(s_tree.nth(0));
+
+  map_type cp_s_tree(s_tree);
+  map_type mv_s_tree(std::move(s_tree));
+  EXPECT_EQ(cp_s_tree.size(), 4U);
+  EXPECT_EQ(mv_s_tree.size(), 4U);
+  EXPECT_TRUE(s_tree.empty());
+  EXPECT_EQ((*mv_s_tree.nth(0)).second, "twenty");
+  EXPECT_EQ(cp_s_tree.at(50), "fifty");
+}
+
+TEST(MapAllocator, PoolPerContainer) {
+  s21::Map<int, int> s_tree = {{1, 1}, {2, 2}, {3, 3}};
+  s21::Map<int, int> cp_s_tree(s_tree);
+  EXPECT_TRUE(s_tree.get_allocator() != cp_s_tree.get_allocator());
+
+  auto alloc = s_tree.get_allocator();
+  s21::Map<int, int> mv_s_tree(std::move(s_tree));
+  EXPECT_TRUE(mv_s_tree.get_allocator() == alloc);
+
+  mv_s_tree.swap(cp_s_tree);
+  EXPECT_TRUE(cp_s_tree.get_allocator() == alloc);
+  EXPECT_EQ(cp_s_tree.size(), 3U);
+  EXPECT_EQ(mv_s_tree.size(), 3U);
+}
+
+TEST(MapModifiers, InsertHint) {
+  s21::Map<int, std::string> s_tree;
+  auto it = s_tree.insert(s_tree.end(), {1, "one"});
+  EXPECT_EQ((*it).second, "one");
+  for (int i = 2; i < 100; ++i) {
+    s_tree.insert(s_tree.end(), {i, std::to_string(i)});
+  }
+  it = s_tree.insert(s_tree.nth(9), {10, "ten"});
+  EXPECT_EQ((*it).second, "10");
+  EXPECT_EQ(s_tree.size(), 99U);
+  EXPECT_EQ(s_tree[99], "99");
+  EXPECT_EQ(s_tree.rank(50), 49U);
+
+  s_tree[0] = "zero";
+  EXPECT_EQ((*s_tree.begin()).second, "zero");
+  EXPECT_EQ(s_tree.size(), 100U);
+}
+
+TEST(MapModifiers, TryEmplace) {
+  s21::Map<int, std::unique_ptr<std::string>> s_tree;
+  auto res = s_tree.try_emplace(1, new std::string("one"));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(*(*res.first).second, "one");
+
+  auto value = std::make_unique<std::string>("two");
+  res = s_tree.try_emplace(2, std::move(value));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(value, nullptr);
+
+  value = std::make_unique<std::string>("uno");
+  res = s_tree.try_emplace(1, std::move(value));
+  EXPECT_FALSE(res.second);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, "uno");
+  EXPECT_EQ(*(*res.first).second, "one");
+
+  auto it = s_tree.try_emplace(s_tree.end(), 3, new std::string("three"));
+  EXPECT_EQ(*(*it).second, "three");
+
+  res = s_tree.emplace(4, std::make_unique<std::string>("four"));
+  EXPECT_TRUE(res.second);
+  it = s_tree.emplace_hint(s_tree.end(), 5, nullptr);
+  EXPECT_EQ((*it).first, 5);
+  EXPECT_EQ(s_tree.size(), 5U);
+}
+
+TEST(MapModifiers, EmplaceExistingKeyBuildsNothing) {
+  s21::Map<int, ::Test> s_tree;
+  s_tree.try_emplace(1, 10);
+  testing::internal::CaptureStdout();
+  auto res = s_tree.try_emplace(1);
+  auto res2 = s_tree.emplace(1, ::Test(30));
+  std::string out = testing::internal::GetCapturedStdout();
+  EXPECT_FALSE(res.second);
+  EXPECT_FALSE(res2.second);
+  EXPECT_EQ((*res.first).second.a, 10);
+  // only the explicit Test(30) argument is ever constructed
+  EXPECT_EQ(out.find("construct"), std::string::npos);
+  EXPECT_EQ(out.find("move"), std::string::npos);
+  EXPECT_EQ(out.find("copy"), std::string::npos);
+}
+
+TEST(MapConstructors, SortedRange) {
+  std::map<int, std::string> o_tree;
+  for (int i = 0; i < 100; ++i) {
+    o_tree[i] = std::to_string(i);
+  }
+  s21::Map<int, std::string> s_tree(o_tree.begin(), o_tree.end());
+  EXPECT_EQ(s_tree.size(), o_tree.size());
+  EXPECT_EQ(s_tree.at(42), "42");
+  EXPECT_EQ((*s_tree.nth(99)).second, "99");
+
+  s_tree.assign_sorted({{1, "one"}, {2, "two"}});
+  EXPECT_EQ(s_tree.size(), 2U);
+  EXPECT_EQ(s_tree[2], "two");
+}
+
+TEST(MapConstructors, CopyEmptyAndSelf) {
+  s21::Map<int, std::string> empty;
+  s21::Map<int, std::string> s_tree(empty);
+  EXPECT_TRUE(s_tree.empty());
+  s_tree = {{1, "one"}, {2, "two"}};
+  auto& alias = s_tree;
+  s_tree = alias;
+  EXPECT_EQ(s_tree.size(), 2U);
+  EXPECT_EQ(s_tree.at(2), "two");
+  s_tree = empty;
+  EXPECT_TRUE(s_tree.empty());
+  s_tree.insert(3, "three");
+  EXPECT_EQ((*s_tree.begin()).second, "three");
+}
+
+TEST(MapAlgebra, UnionIntersectionDifference) {
+  s21::Map<int, std::string> a = {{1, "a1"}, {3, "a3"}, {5, "a5"}};
+  s21::Map<int, std::string> b = {{3, "b3"}, {4, "b4"}, {5, "b5"}};
+  auto u = s21::set_union(a, b);
+  auto i = s21::set_intersection(a, b);
+  auto d = s21::set_difference(a, b);
+  EXPECT_EQ(u.size(), 4U);
+  EXPECT_EQ(u.at(3), "a3");
+  EXPECT_EQ(u.at(4), "b4");
+  EXPECT_EQ(i.size(), 2U);
+  EXPECT_EQ(i.at(5), "a5");
+  EXPECT_EQ(d.size(), 1U);
+  EXPECT_EQ(d.at(1), "a1");
+  EXPECT_TRUE(s21::set_intersection(a, s21::Map<int, std::string>()).empty());
+}
+
+TEST(MapModifiers, MergeLinear) {
+  s21::Map<int, std::string> s_tree = {{1, "one"}, {3, "three"}};
+  s21::Map<int, std::string> other = {{2, "two"}, {3, "drei"}, {4, "four"}};
+  s_tree.merge(other);
+  EXPECT_EQ(s_tree.size(), 4U);
+  EXPECT_EQ(s_tree.at(2), "two");
+  EXPECT_EQ(s_tree.at(3), "three");
+  EXPECT_EQ(other.size(), 1U);
+  EXPECT_EQ(other.at(3), "drei");
+}
+
+TEST(MapLookup, RangeScan) {
+  s21::Map<long, std::string> s_tree;
+  std::map<long, std::string> o_tree;
+  for (long t = 1000; t < 2000; t += 7) {
+    s_tree.insert(t, std::to_string(t));
+    o_tree.emplace(t, std::to_string(t));
+  }
+  auto oi = o_tree.lower_bound(1200);
+  auto last = s_tree.upper_bound(1500);
+  int visited = 0;
+  for (auto si = s_tree.lower_bound(1200); si != last; ++si, ++oi) {
+    EXPECT_EQ((*si).first, oi->first);
+    ++visited;
+  }
+  EXPECT_EQ(oi, o_tree.upper_bound(1500));
+  EXPECT_EQ(visited, 43);
+
+  EXPECT_TRUE(s_tree.lower_bound(5000) == s_tree.end());
+  EXPECT_EQ((*s_tree.upper_bound(0)).first, 1000);
+  auto range = s_tree.equal_range(1007);
+  EXPECT_EQ((*range.first).second, "1007");
+  EXPECT_EQ((*range.second).first, 1014);
+  EXPECT_TRUE(s_tree.find(1008) == s_tree.end());
+
+  s21::Map<int, int> empty;
+  EXPECT_TRUE(empty.begin() == empty.end());
+  EXPECT_TRUE(empty.lower_bound(1) == empty.end());
+}
+
+TEST(MapLookup, TransparentCompare) {
+  s21::Map<std::string, int, std::less<>> s_tree = {
+      {"alpha", 1}, {"beta", 2}, {"gamma", 3}};
+  std::string_view probe = "beta";
+  EXPECT_EQ((*s_tree.find(probe)).second, 2);
+  EXPECT_TRUE(s_tree.contains("gamma"));
+  EXPECT_FALSE(s_tree.contains(std::string_view("delta")));
+  EXPECT_EQ(s_tree.count("alpha"), 1U);
+  EXPECT_EQ((*s_tree.lower_bound("b")).first, "beta");
+  EXPECT_TRUE(s_tree.upper_bound("gamma") == s_tree.end());
+
+  s21::Map<int, int, std::greater<int>> reversed = {{1, 1}, {3, 3}, {2, 2}};
+  EXPECT_EQ((*reversed.begin()).first, 3);
+  EXPECT_EQ((*reversed.lower_bound(2)).first, 2);
+  auto copy = reversed;
+  copy.insert(0, 0);
+  EXPECT_EQ((*copy.nth(3)).first, 0);
+}
+
+TEST(MultimapModifiers, StableEqualKeys) {
+  s21::Multimap<int, std::string> s_tree;
+  std::multimap<int, std::string> o_tree;
+  for (int k = 0; k < 300; ++k) {
+    s_tree.insert(k % 7, std::to_string(k));
+    o_tree.emplace(k % 7, std::to_string(k));
+  }
+  ASSERT_EQ(s_tree.size(), o_tree.size());
+  auto oi = o_tree.begin();
+  for (auto si = s_tree.begin(); si != s_tree.end(); ++si, ++oi) {
+    EXPECT_EQ((*si).first, oi->first);
+    EXPECT_EQ((*si).second, oi->second);
+  }
+
+  EXPECT_EQ(s_tree.count(3), o_tree.count(3));
+  auto range = s_tree.equal_range(3);
+  EXPECT_EQ((*range.first).second, "3");
+  EXPECT_EQ((*range.second).first, 4);
+  EXPECT_EQ((*s_tree.find(6)).second, "6");
+
+  auto hinted = s_tree.insert(s_tree.find(6), {6, "first"});
+  EXPECT_EQ((*s_tree.lower_bound(6)).second, "first");
+  EXPECT_TRUE(hinted == s_tree.lower_bound(6));
+  EXPECT_EQ(s_tree.erase(6), 43U);
+  EXPECT_FALSE(s_tree.contains(6));
+}
+
+TEST(BtreeMapModifiers, MatchesStdMap) {
+  s21::btree_map<long long, std::string> s_tree;
+  std::map<long long, std::string> o_tree;
+  unsigned seed = 12345;
+  for (int step = 0; step < 20000; ++step) {
+    seed = seed * 1103515245 + 12345;
+    long long key = static_cast<long long>(seed >> 8) % 3000 - 1500;
+    if (step % 3 == 2) {
+      EXPECT_EQ(s_tree.erase(key), o_tree.erase(key));
+    } else {
+      auto inserted = s_tree.insert(key, std::to_string(step));
+      EXPECT_EQ(inserted.second,
+                o_tree.emplace(key, std::to_string(step)).second);
+      EXPECT_EQ((*inserted.first).first, key);
+    }
+  }
+  ASSERT_EQ(s_tree.size(), o_tree.size());
+  auto oi = o_tree.begin();
+  for (auto si = s_tree.begin(); si != s_tree.end(); ++si, ++oi) {
+    EXPECT_EQ(si->first, oi->first);
+    EXPECT_EQ(si->second, oi->second);
+  }
+  auto ri = o_tree.rbegin();
+  for (auto si = s_tree.end(); si != s_tree.begin(); ++ri) {
+    --si;
+    EXPECT_EQ((*si).first, ri->first);
+  }
+
+  for (long long key = -1600; key < 1600; key += 7) {
+    auto lower = s_tree.lower_bound(key);
+    auto o_lower = o_tree.lower_bound(key);
+    ASSERT_EQ(lower == s_tree.end(), o_lower == o_tree.end());
+    if (o_lower != o_tree.end()) {
+      EXPECT_EQ((*lower).first, o_lower->first);
+    }
+    auto upper = s_tree.upper_bound(key);
+    auto o_upper = o_tree.upper_bound(key);
+    ASSERT_EQ(upper == s_tree.end(), o_upper == o_tree.end());
+    if (o_upper != o_tree.end()) {
+      EXPECT_EQ((*upper).first, o_upper->first);
+    }
+    EXPECT_EQ(s_tree.contains(key), o_tree.count(key) == 1);
+  }
+
+  while (!s_tree.empty()) {
+    s_tree.erase(s_tree.begin());
+  }
+  EXPECT_TRUE(s_tree.begin() == s_tree.end());
+  s_tree[5] = "five";
+  EXPECT_EQ(s_tree.at(5), "five");
+  EXPECT_THROW(s_tree.at(6), std::out_of_range);
+}
+
+TEST(BtreeMapModifiers, SequentialLoadCopyAndMerge) {
+  s21::btree_map<int, int> s_tree;
+  for (int k = 0; k < 5000; ++k) {
+    s_tree.insert(k, k * 2);
+  }
+  auto copy = s_tree;
+  for (int k = 0; k < 5000; k += 2) {
+    copy.erase(k);
+  }
+  EXPECT_EQ(copy.size(), 2500U);
+  EXPECT_EQ(s_tree.size(), 5000U);
+  EXPECT_EQ((*copy.begin()).second, 2);
+
+  s21::btree_map<int, int> other = {{-1, 0}, {1, 100}, {6000, 0}};
+  other.merge(copy);
+  EXPECT_EQ(other.size(), 2502U);
+  EXPECT_EQ(copy.size(), 1U);
+  EXPECT_EQ(other.at(1), 100);
+  EXPECT_EQ((*copy.begin()).first, 1);
+
+  auto moved = std::move(other);
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(moved.count(4999), 1U);
+  moved.swap(s_tree);
+  EXPECT_EQ(moved.size(), 5000U);
+  EXPECT_EQ(s_tree.size(), 2502U);
+  int expected = 0;
+  for (auto pair : moved) {
+    EXPECT_EQ(pair.first, expected++);
+  }
+}
+
+TEST(BtreeMapModifiers, MergeMovesElements) {
+  s21::btree_map<int, std::unique_ptr<int>> s_tree;
+  s21::btree_map<int, std::unique_ptr<int>> other;
+  std::vector<int*> values(6000);
+  for (int k = 0; k < 6000; ++k) {
+    auto value = std::make_unique<int>(k);
+    values[k] = value.get();
+    other.try_emplace(k, std::move(value));
+    if (k % 3 == 0) s_tree.try_emplace(k, std::make_unique<int>(-k));
+  }
+  s_tree.merge(other);
+  EXPECT_EQ(s_tree.size(), 6000U);
+  EXPECT_EQ(other.size(), 2000U);
+  for (int k = 0; k < 6000; ++k) {
+    auto& kept = (*s_tree.find(k)).second;
+    if (k % 3 == 0) {
+      EXPECT_EQ(*kept, -k);
+      EXPECT_EQ((*other.find(k)).second.get(), values[k]);
+    } else {
+      EXPECT_EQ(kept.get(), values[k]);
+      EXPECT_TRUE(other.find(k) == other.end());
+    }
+  }
+
+  // оставшиеся узлы пересобраны: удаление и вставка идут как обычно
+  int expected = 0;
+  for (auto pair : other) {
+    EXPECT_EQ(pair.first, expected);
+    expected += 3;
+  }
+  for (int k = 0; k < 6000; k += 6) {
+    EXPECT_EQ(other.erase(k), 1U);
+  }
+  for (int k = 1; k < 6000; k += 6) {
+    other.try_emplace(k, std::make_unique<int>(k));
+  }
+  EXPECT_EQ(other.size(), 2000U);
+  expected = 0;
+  for (auto pair : other) {
+    EXPECT_EQ(pair.first, expected % 2 ? 6 * (expected / 2) + 3
+                                       : 6 * (expected / 2) + 1);
+    ++expected;
+  }
+
+  s_tree.merge(other);
+  EXPECT_EQ(s_tree.size(), 6000U);
+  EXPECT_EQ(other.size(), 2000U);
+  other.merge(s_tree);
+  EXPECT_EQ(other.size(), 6000U);
+  EXPECT_EQ(s_tree.size(), 2000U);
+  s21::btree_map<int, std::unique_ptr<int>> empty;
+  empty.merge(other);
+  EXPECT_EQ(empty.size(), 6000U);
+  EXPECT_TRUE(other.empty());
+}
+
+TEST(BtreeSetLookup, Int64MatchesStdSet) {
+  s21::btree_set<std::int64_t> s_tree;
+  std::set<std::int64_t> o_tree;
+  const std::int64_t edges[] = {std::numeric_limits<std::int64_t>::min(),
+                                std::numeric_limits<std::int64_t>::max(),
+                                -1,
+                                0,
+                                0xFFFFFFFFLL,
+                                0x100000000LL,
+                                -0x100000000LL,
+                                0x7FFFFFFFLL,
+                                0x80000000LL};
+  for (std::int64_t key : edges) {
+    s_tree.insert(key);
+    o_tree.insert(key);
+  }
+  std::uint64_t seed = 99;
+  for (int step = 0; step < 4000; ++step) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    std::int64_t key = static_cast<std::int64_t>(seed);
+    if (step % 2) key >>= 31;
+    s_tree.insert(key);
+    o_tree.insert(key);
+  }
+  EXPECT_EQ(s_tree.size(), o_tree.size());
+  seed = 7;
+  for (int step = 0; step < 4000; ++step) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    std::int64_t key = static_cast<std::int64_t>(seed);
+    if (step % 2) key >>= 31;
+    if (step % 3 == 0) key = *std::next(o_tree.begin(), step % o_tree.size());
+    auto lower = o_tree.lower_bound(key);
+    auto upper = o_tree.upper_bound(key);
+    EXPECT_EQ(s_tree.lower_bound(key) == s_tree.end(), lower == o_tree.end());
+    if (lower != o_tree.end()) {
+      EXPECT_EQ(*s_tree.lower_bound(key), *lower);
+    }
+    if (upper != o_tree.end()) {
+      EXPECT_EQ(*s_tree.upper_bound(key), *upper);
+    }
+    EXPECT_EQ(s_tree.contains(key), o_tree.count(key) == 1);
+  }
+  for (std::int64_t key : edges) {
+    auto wrap = [key](std::uint64_t t_step) {
+      return static_cast<std::int64_t>(static_cast<std::uint64_t>(key) +
+                                        t_step);
+    };
+    std::int64_t keys[] = {wrap(-1), key, wrap(1), key, key ^ 1};
+    for (std::int64_t probe : edges) {
+      std::size_t less = 0;
+      std::size_t not_greater = 0;
+      for (std::int64_t k : keys) {
+        less += k < probe;
+        not_greater += !(probe < k);
+      }
+      EXPECT_EQ(s21::btree_count_(keys, 5, probe, false), less);
+      EXPECT_EQ(s21::btree_count_(keys, 5, probe, true), not_greater);
+    }
+  }
+}
+
+TEST(FlatMapModifiers, MatchesStdMap) {
+  s21::flat_map<int, std::string> s_tree;
+  std::map<int, std::string> o_tree;
+  unsigned seed = 777;
+  for (int step = 0; step < 3000; ++step) {
+    seed = seed * 1103515245 + 12345;
+    int key = static_cast<int>((seed >> 8) % 500);
+    if (step % 4 == 3) {
+      EXPECT_EQ(s_tree.erase(key), o_tree.erase(key));
+    } else {
+      EXPECT_EQ(s_tree.insert(key, std::to_string(step)).second,
+                o_tree.emplace(key, std::to_string(step)).second);
+    }
+  }
+  ASSERT_EQ(s_tree.size(), o_tree.size());
+  auto oi = o_tree.begin();
+  for (auto si = s_tree.begin(); si != s_tree.end(); ++si, ++oi) {
+    EXPECT_EQ(si->first, oi->first);
+    EXPECT_EQ(si->second, oi->second);
+  }
+  for (int key = -1; key < 502; ++key) {
+    EXPECT_EQ(s_tree.count_less(key),
+              static_cast<size_t>(std::distance(o_tree.begin(),
+                                                o_tree.lower_bound(key))));
+    auto upper = s_tree.upper_bound(key);
+    auto o_upper = o_tree.upper_bound(key);
+    ASSERT_EQ(upper == s_tree.end(), o_upper == o_tree.end());
+    if (o_upper != o_tree.end()) {
+      EXPECT_EQ((*upper).first, o_upper->first);
+    }
+  }
+  s_tree[1000] = "last";
+  EXPECT_EQ(s_tree.at(1000), "last");
+  EXPECT_EQ((*s_tree.nth(s_tree.size() - 1)).first, 1000);
+  EXPECT_THROW(s_tree.at(1001), std::out_of_range);
+}
+
+TEST(FlatMapModifiers, BulkInsertExtractReplace) {
+  s21::flat_map<int, int> s_tree = {{5, 50}, {1, 10}, {3, 30}};
+  std::vector<std::pair<int, int>> batch = {{4, 40}, {2, 20}, {3, 0},
+                                            {2, 0},  {6, 60}, {0, 0}};
+  s_tree.insert(batch.begin(), batch.end());
+  ASSERT_EQ(s_tree.size(), 7U);
+  for (int k = 0; k < 7; ++k) {
+    EXPECT_EQ((*s_tree.nth(k)).first, k);
+    EXPECT_EQ(s_tree.at(k), k * 10);
+  }
+
+  s21::flat_map<int, int> other = {{3, 333}, {7, 70}};
+  s_tree.merge(other);
+  EXPECT_EQ(s_tree.size(), 8U);
+  EXPECT_EQ(other.size(), 1U);
+  EXPECT_EQ(other.at(3), 333);
+
+  auto parts = s_tree.extract();
+  EXPECT_TRUE(s_tree.empty());
+  ASSERT_EQ(parts.keys.size(), 8U);
+  EXPECT_EQ(parts.values[7], 70);
+  parts.values[0] = -1;
+  s_tree.replace(std::move(parts.keys), std::move(parts.values));
+  EXPECT_EQ(s_tree.at(0), -1);
+  EXPECT_TRUE(s_tree.contains(7));
+  s_tree.insert(8, 80);
+  EXPECT_EQ(s_tree.keys().size(), 9U);
+
+  s21::flat_map<int, int> bad;
+  EXPECT_THROW(bad.replace(s21::vector<int>{1, 2}, s21::vector<int>{1}),
+               std::invalid_argument);
+}
+
+TEST(UnorderedMapModifiers, MatchesStdMap) {
+  s21::unordered_map<int, std::string> s_table;
+  std::map<int, std::string> o_tree;
+  unsigned seed = 2024;
+  for (int step = 0; step < 30000; ++step) {
+    seed = seed * 1103515245 + 12345;
+    int key = static_cast<int>((seed >> 8) % 4000);
+    if (step % 3 == 2) {
+      EXPECT_EQ(s_table.erase(key), o_tree.erase(key));
+    } else {
+      EXPECT_EQ(s_table.insert(key, std::to_string(step)).second,
+                o_tree.emplace(key, std::to_string(step)).second);
+    }
+  }
+  ASSERT_EQ(s_table.size(), o_tree.size());
+  EXPECT_LE(s_table.load_factor(), s_table.max_load_factor());
+  for (auto pair : o_tree) {
+    EXPECT_EQ(s_table.at(pair.first), pair.second);
+  }
+  std::size_t visited = 0;
+  for (auto it = s_table.begin(); it != s_table.end(); ++it, ++visited) {
+    EXPECT_EQ(o_tree.at(it->first), it->second);
+  }
+  EXPECT_EQ(visited, o_tree.size());
+  EXPECT_THROW(s_table.at(-1), std::out_of_range);
+  s_table[-1] = "minus";
+  EXPECT_EQ(s_table.count(-1), 1U);
+
+  auto copy = s_table;
+  s_table.clear();
+  EXPECT_TRUE(s_table.begin() == s_table.end());
+  EXPECT_EQ(copy.size(), o_tree.size() + 1);
+}
+
+namespace {
+// every key lands in one probe chain that wraps around the table end
+struct CollidingHash {
+  std::size_t operator()(int) const noexcept { return ~std::size_t{0}; }
+};
+
+struct StringHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view str) const noexcept {
+    return std::hash<std::string_view>()(str);
+  }
+};
+}  // namespace
+
+TEST(UnorderedMapModifiers, EraseShiftsChainBack) {
+  s21::unordered_map<int, int, CollidingHash> s_table;
+  for (int k = 0; k < 20; ++k) {
+    s_table.insert(k, k);
+  }
+  for (int k = 0; k < 20; k += 3) {
+    EXPECT_EQ(s_table.erase(k), 1U);
+  }
+  for (int k = 0; k < 20; ++k) {
+    EXPECT_EQ(s_table.contains(k), k % 3 != 0);
+  }
+  s_table.erase(s_table.find(1));
+  EXPECT_FALSE(s_table.contains(1));
+  EXPECT_EQ(s_table.size(), 12U);
+
+  s21::unordered_map<std::string, int, StringHash, std::equal_to<>> words;
+  words.reserve(100);
+  std::size_t capacity = words.capacity();
+  for (int k = 0; k < 100; ++k) {
+    words.emplace(std::to_string(k), k);
+  }
+  EXPECT_EQ(words.capacity(), capacity);
+  std::string_view probe = "42";
+  EXPECT_EQ(words.find(probe)->second, 42);
+  EXPECT_TRUE(words.contains("99"));
+  EXPECT_EQ(words.count(std::string_view("100")), 0U);
+
+  s21::unordered_map<std::string, int, StringHash, std::equal_to<>> other = {
+      {"42", -1}, {"new", 1}};
+  words.merge(other);
+  EXPECT_EQ(words.size(), 101U);
+  EXPECT_EQ(other.size(), 1U);
+  EXPECT_EQ(other.at("42"), -1);
+}
+
+TEST(SkiplistMapModifiers, MatchesStdMap) {
+  s21::skiplist_map<int, std::string> s_list;
+  std::map<int, std::string> o_tree;
+  unsigned seed = 99;
+  for (int step = 0; step < 10000; ++step) {
+    seed = seed * 1103515245 + 12345;
+    int key = static_cast<int>((seed >> 8) % 2000);
+    if (step % 3 == 2) {
+      EXPECT_EQ(s_list.erase(key), o_tree.erase(key));
+    } else {
+      EXPECT_EQ(s_list.insert(key, std::to_string(step)).second,
+                o_tree.emplace(key, std::to_string(step)).second);
+    }
+  }
+  ASSERT_EQ(s_list.size(), o_tree.size());
+  EXPECT_TRUE(std::equal(s_list.begin(), s_list.end(), o_tree.begin()));
+  for (int key = -1; key < 2002; key += 5) {
+    auto lower = s_list.lower_bound(key);
+    auto o_lower = o_tree.lower_bound(key);
+    ASSERT_EQ(lower == s_list.end(), o_lower == o_tree.end());
+    if (o_lower != o_tree.end()) {
+      EXPECT_EQ(lower->first, o_lower->first);
+    }
+    auto upper = s_list.upper_bound(key);
+    auto o_upper = o_tree.upper_bound(key);
+    ASSERT_EQ(upper == s_list.end(), o_upper == o_tree.end());
+    if (o_upper != o_tree.end()) {
+      EXPECT_EQ(upper->first, o_upper->first);
+    }
+  }
+
+  s21::skiplist_map<int, std::string> copy = s_list;
+  s_list.clear();
+  EXPECT_TRUE(s_list.empty());
+  EXPECT_EQ(copy.size(), o_tree.size());
+  copy[-5] = "first";
+  EXPECT_EQ(copy.begin()->second, "first");
+  EXPECT_THROW(copy.at(-6), std::out_of_range);
+
+  s21::skiplist_map<int, int> tall(4, s21::skiplist_geometric(0.25));
+  for (int k = 100; k > 0; --k) {
+    tall.insert(k, k);
+  }
+  EXPECT_EQ(tall.begin()->first, 1);
+  EXPECT_EQ(tall.size(), 100U);
+}
+
+TEST(SkiplistMapModifiers, ConcurrentWritersAndReaders) {
+  s21::skiplist_map<int, int> s_list;
+  constexpr int kWriters = 4;
+  constexpr int kPerWriter = 2000;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int w = 0; w < kWriters; ++w) {
+    threads.emplace_back([&s_list, w] {
+      // interleaved keys make writers collide on the same predecessors
+      for (int i = 0; i < kPerWriter; ++i) {
+        s_list.insert(i * kWriters + w, w);
+      }
+      for (int i = 0; i < kPerWriter; i += 2) {
+        s_list.erase(i * kWriters + w);
+      }
+    });
+  }
+  std::atomic<long> hits{0};
+  for (int r = 0; r < 2; ++r) {
+    threads.emplace_back([&s_list, &done, &hits] {
+      while (!done.load()) {
+        for (int key = 0; key < kWriters * kPerWriter; key += 97) {
+          // the guard keeps a concurrently erased element alive
+          auto guard = s_list.pin();
+          auto it = s_list.find(key);
+          if (it != s_list.end()) {
+            EXPECT_EQ(it->first, key);
+            ++hits;
+          }
+        }
+      }
+    });
+  }
+  for (int w = 0; w < kWriters; ++w) {
+    threads[w].join();
+  }
+  done = true;
+  for (std::size_t t = kWriters; t < threads.size(); ++t) {
+    threads[t].join();
+  }
+
+  ASSERT_EQ(s_list.size(), static_cast<size_t>(kWriters * kPerWriter / 2));
+  int previous = -1;
+  for (auto pair : s_list) {
+    EXPECT_LT(previous, pair.first);
+    EXPECT_EQ((pair.first / kWriters) % 2, 1);
+    EXPECT_EQ(pair.second, pair.first % kWriters);
+    previous = pair.first;
+  }
+}
+
+TEST(SkiplistMapModifiers, ChurnKeepsMemoryBounded) {
+  using list_type =
+      s21::skiplist_map<int, int, std::less<int>, s21::skiplist_geometric,
+                        CountingAllocator<std::pair<const int, int>>>;
+  constexpr int kKeys = 256;
+  constexpr long kBatch = s21::defines::SKIPLIST_RECLAIM_BATCH;
+  const long before = counting_live_blocks.load();
+  {
+    // no reader holds an epoch: erased nodes go back within a few batches
+    list_type s_list;
+    long peak = 0;
+    unsigned seed = 5;
+    for (int step = 0; step < 100000; ++step) {
+      seed = seed * 1103515245 + 12345;
+      int key = static_cast<int>((seed >> 8) % kKeys);
+      if (step % 2) {
+        s_list.erase(key);
+      } else {
+        s_list.insert(key, step);
+      }
+      peak = std::max(peak, counting_live_blocks.load() - before);
+    }
+    EXPECT_LE(peak, kKeys + 1 + 4 * kBatch);
+  }
+  EXPECT_EQ(counting_live_blocks.load(), before);
+  {
+    list_type s_list;
+    constexpr int kWriters = 4;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < kWriters; ++w) {
+      threads.emplace_back([&s_list, w] {
+        unsigned seed = 7 + w;
+        for (int step = 0; step < 40000; ++step) {
+          seed = seed * 1103515245 + 12345;
+          int key = static_cast<int>((seed >> 8) % kKeys);
+          if (step % 2) {
+            s_list.erase(key);
+          } else {
+            s_list.insert(key, step);
+          }
+        }
+      });
+    }
+    threads.emplace_back([&s_list, &done] {
+      while (!done.load()) {
+        for (int key = 0; key < kKeys; ++key) {
+          auto guard = s_list.pin();
+          auto it = s_list.find(key);
+          if (it != s_list.end()) {
+            EXPECT_EQ(it->first, key);
+          }
+        }
+      }
+    });
+    for (int w = 0; w < kWriters; ++w) {
+      threads[w].join();
+    }
+    done = true;
+    threads.back().join();
+
+    // once readers are gone the backlog is freed within two epoch steps
+    for (int step = 0; step < 3; ++step) {
+      s_list.reclaim();
+    }
+    EXPECT_EQ(counting_live_blocks.load() - before,
+              static_cast<long>(s_list.size()) + 1);
+  }
+  EXPECT_EQ(counting_live_blocks.load(), before);
+}
+
+TEST(ConcurrentMapModifiers, ShardedWritesAndOrderedScan) {
+  s21::concurrent_map<int, int, 8> c_map;
+  constexpr int kWriters = 4;
+  constexpr int kPerWriter = 1000;
+  std::vector<std::thread> threads;
+  for (int w = 0; w < kWriters; ++w) {
+    threads.emplace_back([&c_map, w] {
+      for (int i = 0; i < kPerWriter; ++i) {
+        int key = i * kWriters + w;
+        EXPECT_TRUE(c_map.insert_or_assign(key, 0));
+        c_map.visit(key, [key](int& value) { value = key * 2; });
+      }
+      for (int i = 0; i < kPerWriter; i += 2) {
+        EXPECT_EQ(c_map.erase(i * kWriters + w), 1U);
+      }
+    });
+  }
+  threads.emplace_back([&c_map] {
+    // scans run against the writers and must always come out sorted
+    for (int round = 0; round < 20; ++round) {
+      int previous = -1;
+      c_map.scan(100, 3000, [&previous](const int& key, const int&) {
+        EXPECT_LT(previous, key);
+        EXPECT_LE(100, key);
+        EXPECT_LT(key, 3000);
+        previous = key;
+      });
+    }
+  });
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(c_map.size(), static_cast<size_t>(kWriters * kPerWriter / 2));
+  EXPECT_FALSE(c_map.find(0).has_value());
+  EXPECT_EQ(c_map.find(kWriters).value_or(-1), kWriters * 2);
+  EXPECT_FALSE(c_map.insert_or_assign(kWriters, 7));
+  EXPECT_TRUE(c_map.cvisit(kWriters, [](const int& v) { EXPECT_EQ(v, 7); }));
+  EXPECT_FALSE(c_map.visit(0, [](int&) { FAIL(); }));
+  EXPECT_EQ(c_map.erase(0), 0U);
+
+  std::vector<int> scanned;
+  c_map.scan(10, 30, [&scanned](const int& key, const int&) {
+    scanned.push_back(key);
+  });
+  EXPECT_EQ(scanned,
+            (std::vector<int>{12, 13, 14, 15, 20, 21, 22, 23, 28, 29}));
+  std::size_t visited = 0;
+  c_map.for_each([&visited](const int&, const int&) { ++visited; });
+  EXPECT_EQ(visited, c_map.size());
+  c_map.clear();
+  EXPECT_TRUE(c_map.empty());
+}
+
+TEST(PersistentMapModifiers, SnapshotsKeepTheirVersion) {
+  s21::persistent_map<int, std::string> p_map;
+  std::map<int, std::string> o_tree;
+  std::vector<s21::persistent_map<int, std::string>> versions;
+  std::vector<std::map<int, std::string>> o_versions;
+  unsigned seed = 7;
+  for (int step = 0; step < 6000; ++step) {
+    seed = seed * 1103515245 + 12345;
+    int key = static_cast<int>((seed >> 8) % 1500);
+    if (step % 3 == 2) {
+      EXPECT_EQ(p_map.erase(key), o_tree.erase(key));
+    } else if (step % 5 == 0) {
+      EXPECT_EQ(p_map.insert_or_assign(key, std::to_string(step)),
+                o_tree.insert_or_assign(key, std::to_string(step)).second);
+    } else {
+      EXPECT_EQ(p_map.insert(key, std::to_string(step)),
+                o_tree.emplace(key, std::to_string(step)).second);
+    }
+    if (step % 500 == 0) {
+      versions.push_back(p_map.snapshot());
+      o_versions.push_back(o_tree);
+    }
+  }
+  ASSERT_EQ(p_map.size(), o_tree.size());
+  EXPECT_TRUE(std::equal(p_map.begin(), p_map.end(), o_tree.begin()));
+  for (std::size_t v = 0; v < versions.size(); ++v) {
+    ASSERT_EQ(versions[v].size(), o_versions[v].size());
+    EXPECT_TRUE(std::equal(versions[v].begin(), versions[v].end(),
+                           o_versions[v].begin()));
+  }
+  for (int key = -1; key < 1502; key += 7) {
+    auto lower = p_map.lower_bound(key);
+    auto o_lower = o_tree.lower_bound(key);
+    ASSERT_EQ(lower == p_map.end(), o_lower == o_tree.end());
+    if (o_lower != o_tree.end()) {
+      EXPECT_EQ(lower->first, o_lower->first);
+    }
+    auto upper = p_map.upper_bound(key);
+    auto o_upper = o_tree.upper_bound(key);
+    ASSERT_EQ(upper == p_map.end(), o_upper == o_tree.end());
+    if (o_upper != o_tree.end()) {
+      EXPECT_EQ(upper->first, o_upper->first);
+    }
+  }
+  auto found = p_map.find(o_tree.begin()->first);
+  ASSERT_NE(found, p_map.end());
+  EXPECT_EQ(std::distance(found, p_map.end()),
+            static_cast<std::ptrdiff_t>(o_tree.size()));
+  EXPECT_THROW(p_map.at(-1), std::out_of_range);
+  // no fixed ancestor array: the stack grows only when the iterator advances
+  static_assert(sizeof(decltype(found)) <= 8 * sizeof(void*));
+  EXPECT_TRUE(std::equal(p_map.upper_bound(700), p_map.end(),
+                         o_tree.upper_bound(700)));
+
+  versions.clear();
+  p_map.clear();
+  EXPECT_TRUE(p_map.empty());
+  EXPECT_EQ(p_map.begin(), p_map.end());
+}
+
+TEST(PersistentMapModifiers, ReadersHoldSnapshotsWithoutLocks) {
+  s21::persistent_map<int, int> p_map;
+  for (int key = 0; key < 1000; ++key) {
+    p_map.insert(key, key);
+  }
+  s21::persistent_map<int, int> published = p_map.snapshot();
+  std::thread reader([version = std::move(published)] {
+    for (int round = 0; round < 50; ++round) {
+      long sum = 0;
+      for (const auto& pair : version) {
+        sum += pair.second;
+      }
+      EXPECT_EQ(sum, 999L * 1000 / 2);
+    }
+  });
+  // the writer keeps changing its own version while the reader walks
+  for (int key = 0; key < 1000; ++key) {
+    p_map.insert_or_assign(key, -key);
+    if (key % 3 == 0) p_map.erase(key);
+  }
+  reader.join();
+  EXPECT_EQ(p_map.size(), 666U);
+  EXPECT_EQ(p_map.at(1), -1);
+}
+
+namespace {
+// copies fail once the shared countdown reaches zero
+struct FragileValue {
+  static inline int copies_left = -1;
+
+  FragileValue(int t_value = 0) : value(t_value) {}
+  FragileValue(const FragileValue& other) : value(other.value) { spend(); }
+  FragileValue& operator=(const FragileValue& other) {
+    spend();
+    value = other.value;
+    return *this;
+  }
+
+  static void spend() {
+    if (copies_left == 0) throw std::runtime_error("copy failed");
+    if (copies_left > 0) --copies_left;
+  }
+
+  int value;
+};
+
+struct CountingLess {
+  static inline long calls = 0;
+  bool operator()(int a, int b) const {
+    ++calls;
+    return a < b;
+  }
+};
+}  // namespace
+
+TEST(PersistentMapModifiers, ThrowingCopyKeepsVersions) {
+  s21::persistent_map<int, FragileValue> p_map;
+  std::map<int, int> o_tree;
+  for (int key = 0; key < 600; key += 2) {
+    p_map.insert(key, FragileValue(key));
+    o_tree.emplace(key, key);
+  }
+  int failures = 0;
+  for (int attempt = 0; attempt < 90; ++attempt) {
+    {
+      // the snapshot shares every node, so each change copies its path
+      s21::persistent_map<int, FragileValue> snapshot = p_map.snapshot();
+      std::map<int, int> before = o_tree;
+      int key = (attempt * 37) % 601;
+      FragileValue::copies_left = attempt % 15;
+      try {
+        // the reference changes only after the persistent map succeeded
+        if (attempt % 3 == 0) {
+          auto erased = p_map.erase(key);
+          EXPECT_EQ(erased, o_tree.erase(key));
+        } else if (attempt % 3 == 1) {
+          bool inserted = p_map.insert(key, FragileValue(-key));
+          EXPECT_EQ(inserted, o_tree.emplace(key, -key).second);
+        } else {
+          bool inserted = p_map.insert_or_assign(key, FragileValue(key + 1));
+          EXPECT_EQ(inserted, o_tree.insert_or_assign(key, key + 1).second);
+        }
+      } catch (const std::runtime_error&) {
+        ++failures;
+      }
+      FragileValue::copies_left = -1;
+      ASSERT_EQ(snapshot.size(), before.size());
+      auto kept = before.begin();
+      for (const auto& pair : snapshot) {
+        EXPECT_EQ(pair.second.value, (kept++)->second);
+      }
+    }
+    // a failed change leaves the version as it was
+    ASSERT_EQ(p_map.size(), o_tree.size());
+    auto expected = o_tree.begin();
+    for (const auto& pair : p_map) {
+      EXPECT_EQ(pair.first, expected->first);
+      EXPECT_EQ(pair.second.value, expected->second);
+      ++expected;
+    }
+  }
+  EXPECT_GT(failures, 0);
+  EXPECT_LT(failures, 90);
+}
+
+TEST(PersistentMapLookup, ScanDoesNotCompare) {
+  s21::persistent_map<int, int, CountingLess> p_map;
+  for (int key = 0; key < 5000; ++key) {
+    p_map.insert((key * 7919) % 5000, key);
+  }
+  CountingLess::calls = 0;
+  int expected = 0;
+  for (const auto& pair : p_map) {
+    EXPECT_EQ(pair.first, expected++);
+  }
+  EXPECT_EQ(CountingLess::calls, 0);
+  EXPECT_EQ(expected, 5000);
+
+  // an iterator from find builds its stack once, then walks without compares
+  auto it = p_map.find(2500);
+  CountingLess::calls = 0;
+  EXPECT_EQ(std::distance(it, p_map.end()), 2500);
+  EXPECT_LT(CountingLess::calls, 64);
+}
+
+namespace {
+// non-commutative: catches aggregates combined out of key order
+struct ConcatMonoid {
+  using value_type = std::string;
+  static value_type identity() { return std::string(); }
+  static value_type lift(const std::string& value) { return value; }
+  static value_type combine(const value_type& a, const value_type& b) {
+    return a + b;
+  }
+};
+}  // namespace
+
+TEST(AugmentedMapAggregate, RangeSumsMatchStdMap) {
+  s21::augmented_map<int, long> sums;
+  s21::augmented_map<int, long, s21::aggregate_min<long>> mins;
+  std::map<int, long> o_tree;
+  unsigned seed = 3;
+  for (int step = 0; step < 8000; ++step) {
+    seed = seed * 1103515245 + 12345;
+    int key = static_cast<int>((seed >> 8) % 1000);
+    long value = static_cast<long>((seed >> 4) % 2001) - 1000;
+    if (step % 4 == 3) {
+      EXPECT_EQ(sums.erase(key), o_tree.erase(key));
+      mins.erase(key);
+    } else {
+      EXPECT_EQ(sums.insert_or_assign(key, value).second,
+                o_tree.insert_or_assign(key, value).second);
+      mins.insert_or_assign(key, value);
+    }
+  }
+  ASSERT_EQ(sums.size(), o_tree.size());
+  for (int lo = -10; lo < 1010; lo += 37) {
+    for (int hi = lo; hi < 1010; hi += 113) {
+      long sum = 0;
+      long min = std::numeric_limits<long>::max();
+      for (auto it = o_tree.lower_bound(lo);
+           it != o_tree.end() && it->first < hi; ++it) {
+        sum += it->second;
+        min = std::min(min, it->second);
+      }
+      EXPECT_EQ(sums.aggregate(lo, hi), sum);
+      EXPECT_EQ(mins.aggregate(lo, hi), min);
+    }
+  }
+  long total = 0;
+  for (const auto& pair : o_tree) total += pair.second;
+  EXPECT_EQ(sums.aggregate(), total);
+  EXPECT_TRUE(std::equal(sums.begin(), sums.end(), o_tree.begin(),
+                         [](auto a, const std::pair<const int, long>& b) {
+                           return a.first == b.first && a.second == b.second;
+                         }));
+
+  s21::augmented_map<int, long> copy = sums;
+  copy.clear();
+  EXPECT_EQ(copy.aggregate(), 0L);
+  EXPECT_EQ(sums.aggregate(), total);
+}
+
+TEST(AugmentedMapAggregate, KeepsKeyOrderThroughBulkBuildAndMerge) {
+  s21::augmented_map<int, std::string, ConcatMonoid> letters{
+      {1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}, {5, "e"}, {6, "f"}};
+  EXPECT_EQ(letters.aggregate(), "abcdef");
+  EXPECT_EQ(letters.aggregate(2, 5), "bcd");
+  EXPECT_EQ(letters.aggregate(5, 2), "");
+  letters.insert_or_assign(3, "C");
+  letters.erase(5);
+  EXPECT_EQ(letters.aggregate(0, 100), "abCdf");
+  s21::augmented_map<int, std::string, ConcatMonoid> more{
+      {0, "<"}, {3, "x"}, {7, ">"}};
+  letters.merge(more);
+  EXPECT_EQ(letters.aggregate(), "<abCdf>");
+  EXPECT_EQ(more.aggregate(), "x");
+  EXPECT_EQ(letters.at(0), "<");
+  EXPECT_THROW(letters.at(5), std::out_of_range);
+}
+
+TEST(FrozenSetLookup, EveryShapeMatchesStdSet) {
+  // sizes around powers of two cover full and partial last levels
+  for (int n = 0; n < 70; ++n) {
+    s21::Set<int> tree;
+    std::set<int> o_set;
+    for (int i = 0; i < n; ++i) {
+      tree.insert(i * 3);
+      o_set.insert(i * 3);
+    }
+    s21::frozen_set<int> frozen = tree.freeze();
+    ASSERT_EQ(frozen.size(), o_set.size());
+    ASSERT_TRUE(std::equal(frozen.begin(), frozen.end(), o_set.begin(),
+                           o_set.end()));
+    std::vector<int> backwards(o_set.rbegin(), o_set.rend());
+    std::vector<int> walked;
+    for (auto it = frozen.end(); it != frozen.begin();) {
+      walked.push_back(*--it);
+    }
+    EXPECT_EQ(walked, backwards);
+
+    std::vector<int> queries;
+    for (int key = -2; key < n * 3 + 2; ++key) {
+      queries.push_back(key);
+      auto lower = frozen.lower_bound(key);
+      auto o_lower = o_set.lower_bound(key);
+      ASSERT_EQ(lower == frozen.end(), o_lower == o_set.end());
+      if (o_lower != o_set.end()) {
+        EXPECT_EQ(*lower, *o_lower);
+      }
+      auto upper = frozen.upper_bound(key);
+      auto o_upper = o_set.upper_bound(key);
+      ASSERT_EQ(upper == frozen.end(), o_upper == o_set.end());
+      if (o_upper != o_set.end()) {
+        EXPECT_EQ(*upper, *o_upper);
+      }
+      EXPECT_EQ(frozen.contains(key), o_set.count(key) == 1);
+    }
+    std::vector<bool> found;
+    frozen.contains_many(queries.begin(), queries.end(),
+                         std::back_inserter(found));
+    ASSERT_EQ(found.size(), queries.size());
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+      EXPECT_EQ(found[q], o_set.count(queries[q]) == 1);
+    }
+  }
+}
+
+TEST(FrozenMapLookup, FreezeAndBatchFind) {
+  s21::Map<std::string, int> tree;
+  for (int i = 0; i < 300; ++i) {
+    tree.insert("key" + std::to_string(i * 7 % 300), i);
+  }
+  s21::frozen_map<std::string, int> frozen = tree.freeze();
+  ASSERT_EQ(frozen.size(), tree.size());
+  EXPECT_TRUE(std::equal(frozen.begin(), frozen.end(), tree.begin(),
+                         [](auto a, std::pair<std::string, int>& b) {
+                           return a.first == b.first && a.second == b.second;
+                         }));
+  EXPECT_EQ(frozen.at("key14"), tree.at("key14"));
+  EXPECT_THROW(frozen.at("nokey"), std::out_of_range);
+  EXPECT_EQ(frozen.find("key299")->second, tree.at("key299"));
+
+  std::vector<std::string> queries{"key5", "nokey", "key0", "key300", "key77"};
+  std::vector<s21::frozen_map<std::string, int>::iterator> hits;
+  frozen.find_many(queries.begin(), queries.end(), std::back_inserter(hits));
+  ASSERT_EQ(hits.size(), queries.size());
+  EXPECT_EQ((*hits[0]).second, tree.at("key5"));
+  EXPECT_EQ(hits[1], frozen.end());
+  EXPECT_EQ((*hits[2]).second, tree.at("key0"));
+  EXPECT_EQ(hits[3], frozen.end());
+  EXPECT_EQ((*hits[4]).second, tree.at("key77"));
+
+  s21::frozen_map<int, char> unsorted{{3, 'c'}, {1, 'a'}, {3, 'x'}, {2, 'b'}};
+  EXPECT_EQ(unsorted.size(), 3U);
+  EXPECT_EQ(unsorted.at(3), 'c');
+  EXPECT_EQ((*unsorted.begin()).first, 1);
+}
+
+TEST(MapLookup, FindManyMatchesFind) {
+  s21::Map<int, int> tree;
+  for (int i = 0; i < 5000; ++i) {
+    tree.insert(i * 2, i);
+  }
+  // a batch of 1024 mixes hits and misses and spans several groups
+  std::vector<int> keys;
+  unsigned seed = 11;
+  for (int i = 0; i < 1024; ++i) {
+    seed = seed * 1103515245 + 12345;
+    keys.push_back(static_cast<int>((seed >> 8) % 10010) - 5);
+  }
+  std::vector<s21::Map<int, int>::iterator> found;
+  tree.find_many(keys, std::back_inserter(found));
+  ASSERT_EQ(found.size(), keys.size());
+  std::vector<bool> present;
+  tree.contains_many(keys.begin(), keys.end(), std::back_inserter(present));
+  for (std::size_t q = 0; q < keys.size(); ++q) {
+    EXPECT_EQ(found[q], tree.find(keys[q]));
+    EXPECT_EQ(present[q], tree.contains(keys[q]));
+  }
+
+  s21::Map<int, int> empty;
+  std::vector<bool> none;
+  empty.contains_many(keys, std::back_inserter(none));
+  EXPECT_EQ(std::count(none.begin(), none.end(), true), 0);
+}
+
+TEST(SetLookup, ContainsManyWritesBits) {
+  s21::Set<std::string> words{"alpha", "beta", "gamma", "delta"};
+  const std::string queries[] = {"beta", "omega", "alpha", "", "delta"};
+  bool bits[5] = {};
+  bool* end = words.contains_many(queries, bits);
+  EXPECT_EQ(end, bits + 5);
+  EXPECT_TRUE(bits[0]);
+  EXPECT_FALSE(bits[1]);
+  EXPECT_TRUE(bits[2]);
+  EXPECT_FALSE(bits[3]);
+  EXPECT_TRUE(bits[4]);
+}
+
+TEST(MappedMapLookup, SaveThenServeFromMapping) {
+  const std::string path = ::testing::TempDir() + "s21_mapped_map.bin";
+  s21::Map<int, double> tree;
+  for (int i = 0; i < 5000; ++i) {
+    tree.insert(i * 3, i * 0.5);
+  }
+  tree.save(path);
+
+  auto mapped = s21::mapped_map<int, double>::open(path);
+  ASSERT_EQ(mapped.size(), tree.size());
+  EXPECT_TRUE(std::equal(mapped.begin(), mapped.end(), tree.begin(),
+                         [](auto a, std::pair<int, double>& b) {
+                           return a.first == b.first && a.second == b.second;
+                         }));
+  for (int key = -2; key < 15005; key += 7) {
+    auto lower = mapped.lower_bound(key);
+    auto o_lower = tree.lower_bound(key);
+    ASSERT_EQ(lower == mapped.end(), o_lower == tree.end());
+    if (o_lower != tree.end()) {
+      EXPECT_EQ(lower->first, (*o_lower).first);
+    }
+    auto upper = mapped.upper_bound(key);
+    auto o_upper = tree.upper_bound(key);
+    ASSERT_EQ(upper == mapped.end(), o_upper == tree.end());
+    if (o_upper != tree.end()) {
+      EXPECT_EQ(upper->first, (*o_upper).first);
+    }
+    EXPECT_EQ(mapped.contains(key), tree.contains(key));
+  }
+  EXPECT_EQ(mapped.at(300), tree.at(300));
+  EXPECT_THROW(mapped.at(301), std::out_of_range);
+
+  // a moved-to map keeps the mapping alive after the source is gone
+  s21::mapped_map<int, double> moved = std::move(mapped);
+  EXPECT_TRUE(mapped.empty());
+  EXPECT_EQ(moved.find(2997)->second, tree.at(2997));
+
+  EXPECT_THROW((s21::mapped_map<int, float>::open(path)), std::runtime_error);
+  EXPECT_THROW((s21::mapped_set<int>::open(path)), std::runtime_error);
+  EXPECT_THROW((s21::mapped_map<int, double>::open(path + ".missing")),
+               std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(MappedSetLookup, EmptyAndTruncatedImages) {
+  const std::string path = ::testing::TempDir() + "s21_mapped_set.bin";
+  s21::Set<long> empty;
+  empty.save(path);
+  s21::mapped_set<long> none = s21::mapped_set<long>::open(path);
+  EXPECT_TRUE(none.empty());
+  EXPECT_EQ(none.begin(), none.end());
+  EXPECT_FALSE(none.contains(1));
+
+  s21::Set<long> keys{5, 1, 9, 3};
+  keys.save(path);
+  s21::mapped_set<long> mapped = s21::mapped_set<long>::open(path);
+  EXPECT_EQ(std::vector<long>(mapped.begin(), mapped.end()),
+            (std::vector<long>{1, 3, 5, 9}));
+  EXPECT_EQ(*mapped.lower_bound(4), 5);
+
+  // cutting off the index makes the sections overrun the file
+  {
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+  }
+  EXPECT_THROW(s21::mapped_set<long>::open(path), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(NodeHandle, MapMovesNodeBetweenTrees) {
+  s21::pool_allocator<std::pair<const int, std::string>> shared;
+  s21::Map<int, std::string> hot(shared);
+  s21::Map<int, std::string> cold(shared);
+  for (int i = 0; i < 20; ++i) {
+    hot.insert(i, std::to_string(i));
+  }
+  const std::string* element = &hot.at(5);
+
+  auto handle = hot.extract(5);
+  ASSERT_FALSE(handle.empty());
+  EXPECT_EQ(hot.size(), 19U);
+  EXPECT_FALSE(hot.contains(5));
+  handle.key() = 105;
+  auto result = cold.insert(std::move(handle));
+  EXPECT_TRUE(result.inserted);
+  EXPECT_TRUE(result.node.empty());
+  EXPECT_EQ((*result.position).first, 105);
+  EXPECT_EQ(&cold.at(105), element);
+
+  // a clash leaves the element in the handle
+  cold.insert(7, "cold");
+  auto clash = cold.insert(hot.extract(hot.find(7)));
+  EXPECT_FALSE(clash.inserted);
+  EXPECT_EQ((*clash.position).second, "cold");
+  ASSERT_FALSE(clash.node.empty());
+  EXPECT_EQ(clash.node.mapped(), "7");
+  EXPECT_EQ(hot.size(), 18U);
+
+  EXPECT_TRUE(hot.extract(5).empty());
+  auto none = cold.insert(s21::Map<int, std::string>::node_type());
+  EXPECT_FALSE(none.inserted);
+  EXPECT_EQ(none.position, cold.end());
+
+  // default maps own separate pools: the node is relinked all the same,
+  // and the destination keeps the source's slabs alive
+  s21::Map<int, std::string> other;
+  {
+    s21::Map<int, std::string> source;
+    for (int i = 0; i < 100; ++i) {
+      source.insert(i, std::string(32, 'a' + i % 26));
+    }
+    const std::string* block = &source.at(42);
+    auto moved = other.insert(source.extract(42));
+    EXPECT_TRUE(moved.inserted);
+    EXPECT_EQ(&other.at(42), block);
+    other.merge(source);
+    EXPECT_TRUE(source.empty());
+    EXPECT_EQ(&other.at(42), block);
+  }
+  EXPECT_EQ(other.size(), 100U);
+  EXPECT_EQ(other.at(7), std::string(32, 'h'));
+  other.erase(other.find(7));
+  other.insert(other.end(), cold.extract(105));
+  EXPECT_EQ(other.at(105), "5");
+  EXPECT_EQ(cold.size(), 1U);
+  EXPECT_TRUE(std::is_sorted(hot.begin(), hot.end(),
+                             [](const auto& a, const auto& b) {
+                               return a.first < b.first;
+                             }));
+}
+
+TEST(NodeHandle, SetAndMultisetReinsertWithNewKey) {
+  s21::Set<int> set{1, 2, 3};
+  auto only = s21::Set<int>{4};
+  auto handle = only.extract(4);
+  EXPECT_TRUE(only.empty());
+  EXPECT_EQ(only.begin(), only.end());
+  handle.value() = 0;
+  EXPECT_TRUE(set.insert(std::move(handle)).inserted);
+  auto back = set.extract(set.begin());
+  back.value() = 9;
+  set.insert(set.end(), std::move(back));
+  std::vector<int> keys;
+  for (int key : set) keys.push_back(key);
+  EXPECT_EQ(keys, (std::vector<int>{1, 2, 3, 9}));
+  only.insert(set.extract(2));
+  EXPECT_EQ(*only.begin(), 2);
+
+  s21::Multiset<int> multi{5, 5, 7};
+  auto five = multi.extract(5);
+  EXPECT_EQ(multi.count(5), 1U);
+  multi.insert(std::move(five));
+  five = multi.extract(multi.find(7));
+  five.value() = 5;
+  multi.insert(std::move(five));
+  EXPECT_EQ(multi.count(5), 3U);
+  EXPECT_EQ(multi.size(), 3U);
+  EXPECT_TRUE(multi.extract(8).empty());
+}
+
 TEST(SetConstructor, Default) {
   s21::Set<std::string> s;
   std::set<std::string> b;
@@ -905,12 +2306,14 @@ TEST(SetModifiers, Emplace) {
   EXPECT_EQ(s_tree.size(), o_tree.size());
   EXPECT_EQ(s_tree.empty(), o_tree.empty());
 
-  auto v = s_tree.emplace("eleven", "twelve", "nine", "thirteen");
+  std::vector<std::pair<s21::Set<std::string>::iterator, bool>> v = {
+      s_tree.emplace("eleven"), s_tree.emplace(std::string("twelve")),
+      s_tree.emplace("nine"), s_tree.emplace(3, 't')};
 
   auto p0 = o_tree.emplace("eleven");
   auto p1 = o_tree.emplace("twelve");
   auto p2 = o_tree.emplace("nine");
-  auto p3 = o_tree.emplace("thirteen");
+  auto p3 = o_tree.emplace(3, 't');
 
   EXPECT_EQ((*(v[0].first)), (*(p0.first)));
   EXPECT_EQ(v[0].second, p0.second);
@@ -934,6 +2337,640 @@ TEST(SetModifiers, Emplace) {
   }
 }
 
+TEST(SetLookup, OrderStatistics) {
+  s21::Set<int> s_tree;
+  std::set<int> o_tree;
+  for (int i = 0; i < 200; ++i) {
+    int key = (i * 37) % 101;
+    s_tree.insert(key);
+    o_tree.insert(key);
+  }
+  EXPECT_EQ(s_tree.size(), o_tree.size());
+
+  size_t k = 0;
+  for (auto oi = o_tree.begin(); oi != o_tree.end(); ++oi, ++k) {
+    EXPECT_EQ(*s_tree.nth(k), *oi);
+    EXPECT_EQ(s_tree.rank(*oi), k);
+    EXPECT_EQ(s_tree.count_less(*oi), k);
+  }
+
+  while (s_tree.size() > 50) {
+    auto it = s_tree.nth(s_tree.size() / 2);
+    o_tree.erase(*it);
+    s_tree.erase(it);
+    EXPECT_EQ(s_tree.size(), o_tree.size());
+  }
+
+  k = 0;
+  for (auto oi = o_tree.begin(); oi != o_tree.end(); ++oi, ++k) {
+    EXPECT_EQ(*s_tree.nth(k), *oi);
+  }
+
+  s_tree.clear();
+  EXPECT_TRUE(s_tree.empty());
+  EXPECT_EQ(s_tree.count_less(10), 0U);
+}
+
+TEST(SetModifiers, EraseKeepsBalance) {
+  TestOther<s21::Set<int>> s_tree;
+  std::set<int> o_tree;
+  unsigned state = 7;
+  for (int i = 0; i < 20000; ++i) {
+    state = state * 1103515245U + 12345U;
+    int key = static_cast<int>((state >> 8) % 2000);
+    if (state & 0x10) {
+      s_tree.insert(key);
+      o_tree.insert(key);
+    } else if (s_tree.contains(key)) {
+      s_tree.erase(s_tree.find(key));
+      o_tree.erase(key);
+    }
+  }
+
+  ASSERT_TRUE(s_tree.is_valid_tree());
+  EXPECT_EQ(s_tree.size(), o_tree.size());
+  EXPECT_LE(s_tree.height(), 2 * std::log2(s_tree.size() + 1));
+
+  auto si = s_tree.begin();
+  for (auto oi = o_tree.begin(); oi != o_tree.end(); ++oi, ++si) {
+    EXPECT_EQ(*si, *oi);
+  }
+
+  while (!o_tree.empty()) {
+    int key = *o_tree.begin();
+    s_tree.erase(s_tree.find(key));
+    o_tree.erase(o_tree.begin());
+    if (!o_tree.empty()) {
+      EXPECT_EQ(*s_tree.begin(), *o_tree.begin());
+    }
+  }
+  EXPECT_TRUE(s_tree.empty());
+  EXPECT_TRUE(s_tree.is_valid_tree());
+}
+
+TEST(PoolAllocator, ReusesFreedBlocks) {
+  s21::pool_allocator<std::pair<const int, int>> alloc;
+  s21::pool_allocator<long double> rebound(alloc);
+  EXPECT_TRUE(alloc == rebound);
+
+  auto first = alloc.allocate(1);
+  auto second = alloc.allocate(1);
+  EXPECT_NE(first, second);
+  alloc.deallocate(first, 1);
+  EXPECT_EQ(alloc.allocate(1), first);
+
+  auto array = alloc.allocate(10);
+  alloc.deallocate(array, 10);
+  alloc.deallocate(first, 1);
+  alloc.deallocate(second, 1);
+
+  s21::pool_allocator<int> other;
+  EXPECT_TRUE(alloc != other);
+}
+
+class KeyOnly {
+ public:
+  explicit KeyOnly(int value) : value_(value) {}
+
+  friend bool operator<(const KeyOnly& a, const KeyOnly& b) {
+    return a.value_ < b.value_;
+  }
+  friend bool operator>(const KeyOnly& a, const KeyOnly& b) { return b < a; }
+  friend bool operator<=(const KeyOnly& a, const KeyOnly& b) {
+    return !(b < a);
+  }
+  friend bool operator==(const KeyOnly& a, const KeyOnly& b) {
+    return a.value_ == b.value_;
+  }
+
+  int value_;
+};
+
+TEST(SetModifiers, KeyOnlyNodes) {
+  static_assert(sizeof(s21::tree_el_<int, void>) <
+                    sizeof(s21::tree_el_<int, int>),
+                "Set nodes must not carry a mapped value.");
+
+  s21::Set<KeyOnly> s_tree;
+  for (int i : {5, 1, 4, 2, 3, 4}) {
+    s_tree.insert(KeyOnly(i));
+  }
+  EXPECT_EQ(s_tree.size(), 5U);
+  EXPECT_TRUE(s_tree.contains(KeyOnly(3)));
+  EXPECT_FALSE(s_tree.contains(KeyOnly(6)));
+
+  int expected = 1;
+  for (auto it = s_tree.begin(); expected <= 5; ++it, ++expected) {
+    EXPECT_EQ((*it).value_, expected);
+  }
+}
+
+class CountedKey {
+ public:
+  explicit CountedKey(int value) : value_(value) {}
+
+  friend bool operator<(const CountedKey& a, const CountedKey& b) {
+    ++comparisons;
+    return a.value_ < b.value_;
+  }
+  friend bool operator>(const CountedKey& a, const CountedKey& b) {
+    return b < a;
+  }
+  friend bool operator<=(const CountedKey& a, const CountedKey& b) {
+    return !(b < a);
+  }
+  friend bool operator==(const CountedKey& a, const CountedKey& b) {
+    ++comparisons;
+    return a.value_ == b.value_;
+  }
+
+  static inline std::size_t comparisons = 0;
+  int value_;
+};
+
+TEST(SetModifiers, InsertHint) {
+  s21::Set<CountedKey> s_tree;
+  CountedKey::comparisons = 0;
+  for (int i = 0; i < 1000; ++i) {
+    s_tree.insert(s_tree.end(), CountedKey(i));
+  }
+  EXPECT_LE(CountedKey::comparisons, 2000U);
+
+  CountedKey::comparisons = 0;
+  auto existing = s_tree.insert(s_tree.nth(500), CountedKey(500));
+  EXPECT_EQ((*existing).value_, 500);
+  EXPECT_LE(CountedKey::comparisons, 2U);
+  EXPECT_EQ(s_tree.size(), 1000U);
+
+  s21::Set<int> s_set;
+  std::set<int> o_set;
+  for (int i = 0; i < 500; ++i) {
+    int key = (i * 7919) % 1009;
+    auto hint = s_set.nth((i * 31) % (s_set.size() + 1));
+    EXPECT_EQ(*s_set.insert(hint, key), key);
+    o_set.insert(key);
+  }
+  EXPECT_EQ(s_set.size(), o_set.size());
+  auto si = s_set.begin();
+  for (auto oi = o_set.begin(); oi != o_set.end(); ++oi, ++si) {
+    EXPECT_EQ(*si, *oi);
+  }
+}
+
+TEST(SetModifiers, InsertSingleDescent) {
+  s21::Set<CountedKey> s_tree;
+  for (int i = 0; i < 1024; ++i) {
+    s_tree.insert(CountedKey((i * 397) % 1024));
+  }
+  TestOther<s21::Set<int>> heights;
+  for (int i = 0; i < 1024; ++i) {
+    heights.insert((i * 397) % 1024);
+  }
+
+  CountedKey::comparisons = 0;
+  auto res = s_tree.insert(CountedKey(2000));
+  EXPECT_TRUE(res.second);
+  EXPECT_LE(CountedKey::comparisons, 1U);
+
+  CountedKey::comparisons = 0;
+  res = s_tree.insert(CountedKey(511));
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ((*res.first).value_, 511);
+  EXPECT_LE(CountedKey::comparisons,
+            static_cast<std::size_t>(2 * heights.height() + 1));
+}
+
+TEST(SetModifiers, EmplaceHint) {
+  s21::Set<std::string> s_tree;
+  auto it = s_tree.emplace_hint(s_tree.end(), 3, 'a');
+  EXPECT_EQ(*it, "aaa");
+  it = s_tree.emplace_hint(s_tree.end(), "bbb");
+  EXPECT_EQ(*it, "bbb");
+  it = s_tree.emplace_hint(s_tree.begin(), "aaa");
+  EXPECT_EQ(*it, "aaa");
+  EXPECT_EQ(s_tree.size(), 2U);
+
+  s21::Set<std::unique_ptr<int>> ptrs;
+  auto res = ptrs.emplace(new int(5));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(**res.first, 5);
+}
+
+TEST(SetConstructors, SortedRange) {
+  std::vector<int> keys;
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back(i * 3);
+  }
+  TestOther<s21::Set<int>> s_tree;
+  s_tree.assign_sorted(keys.begin(), keys.end());
+  ASSERT_TRUE(s_tree.is_valid_tree());
+  EXPECT_EQ(s_tree.size(), keys.size());
+  EXPECT_LE(s_tree.height(), 11);
+
+  // узлы пришли из одного слэба и лежат подряд
+  auto stride = reinterpret_cast<char*>(s_tree.nth(1).iter) -
+                reinterpret_cast<char*>(s_tree.nth(0).iter);
+  for (size_t k = 0; k < keys.size(); ++k) {
+    EXPECT_EQ(*s_tree.nth(k), keys[k]);
+    EXPECT_EQ(reinterpret_cast<char*>(s_tree.nth(k).iter) -
+                  reinterpret_cast<char*>(s_tree.nth(0).iter),
+              static_cast<std::ptrdiff_t>(k) * stride);
+  }
+
+  for (size_t n = 0; n < 70; ++n) {
+    TestOther<s21::Set<int>> small;
+    small.assign_sorted(keys.begin(), keys.begin() + n);
+    EXPECT_TRUE(small.is_valid_tree());
+    EXPECT_EQ(small.size(), n);
+  }
+
+  s_tree.erase(s_tree.find(30));
+  s_tree.insert(31);
+  EXPECT_TRUE(s_tree.is_valid_tree());
+  EXPECT_EQ(s_tree.count_less(32), 11U);
+}
+
+TEST(SetConstructors, UnsortedAndDuplicateRange) {
+  std::vector<int> keys = {1, 2, 2, 3, 5, 4, 4, 0, 9, 9};
+  TestOther<s21::Set<int>> s_tree;
+  s_tree.assign_sorted(keys.begin(), keys.end());
+  std::set<int> o_tree(keys.begin(), keys.end());
+  EXPECT_TRUE(s_tree.is_valid_tree());
+  EXPECT_EQ(s_tree.size(), o_tree.size());
+  auto si = s_tree.begin();
+  for (auto oi = o_tree.begin(); oi != o_tree.end(); ++oi, ++si) {
+    EXPECT_EQ(*si, *oi);
+  }
+
+  s21::Set<std::string> from_list = {"c", "a", "b"};
+  EXPECT_EQ(*from_list.begin(), "a");
+  std::vector<std::string> words = {"d", "e"};
+  from_list.insert(words.begin(), words.end());
+  EXPECT_EQ(from_list.size(), 5U);
+  EXPECT_EQ(*from_list.nth(4), "e");
+}
+
+TEST(SetLookup, CustomCompare) {
+  struct by_length {
+    bool operator()(const std::string& a, const std::string& b) const {
+      return a.size() < b.size();
+    }
+  };
+  s21::Set<std::string, by_length> s_tree = {"ccc", "a", "bb", "dd"};
+  EXPECT_EQ(s_tree.size(), 3U);
+  EXPECT_EQ(*s_tree.begin(), "a");
+  EXPECT_TRUE(s_tree.contains("zz"));
+  EXPECT_EQ(s_tree.count("qqq"), 1U);
+
+  TestOther<s21::Set<int, std::greater<int>>> desc;
+  for (int k = 0; k < 100; ++k) desc.insert(k);
+  EXPECT_TRUE(desc.is_valid_tree());
+  EXPECT_EQ(*desc.nth(0), 99);
+  EXPECT_EQ(*desc.upper_bound(50), 49);
+  auto both = s21::set_intersection(desc, desc);
+  EXPECT_EQ(*both.begin(), 99);
+}
+
+TEST(SetLookup, BoundsOnStrings) {
+  std::vector<std::string> words = {"pear", "apple", "fig",  "kiwi",
+                                    "lime", "date",  "plum", "banana"};
+  s21::Set<std::string> s_tree(words.begin(), words.end());
+  std::set<std::string> o_tree(words.begin(), words.end());
+  for (std::string probe : {"", "a", "apple", "cherry", "lime", "plum", "z"}) {
+    auto sl = s_tree.lower_bound(probe);
+    auto ol = o_tree.lower_bound(probe);
+    if (ol == o_tree.end()) {
+      EXPECT_TRUE(sl == s_tree.end());
+    } else {
+      EXPECT_EQ(*sl, *ol);
+    }
+    auto su = s_tree.upper_bound(probe);
+    auto ou = o_tree.upper_bound(probe);
+    if (ou == o_tree.end()) {
+      EXPECT_TRUE(su == s_tree.end());
+    } else {
+      EXPECT_EQ(*su, *ou);
+    }
+  }
+
+  // полный обход в обе стороны доходит до end()
+  size_t steps = 0;
+  for (auto it = s_tree.begin(); it != s_tree.end(); ++it) ++steps;
+  EXPECT_EQ(steps, words.size());
+  auto it = s_tree.begin();
+  --it;
+  EXPECT_TRUE(it == s_tree.end());
+  --it;
+  EXPECT_EQ(*it, "plum");
+}
+
+TEST(SetLookup, EqualRangeWithRepeatedKeys) {
+  s21::Set<int> s_tree;
+  for (int k = 0; k < 50; ++k) {
+    s_tree.insert_tree_multiset(k % 5);
+  }
+  auto range = s_tree.equal_range(3);
+  int count = 0;
+  for (auto it = range.first; it != range.second; ++it) {
+    EXPECT_EQ(*it, 3);
+    ++count;
+  }
+  EXPECT_EQ(count, 10);
+  EXPECT_EQ(*s_tree.upper_bound(3), 4);
+  EXPECT_TRUE(s_tree.upper_bound(4) == s_tree.end());
+}
+
+TEST(SetModifiers, MultisetInsertIterative) {
+  TestOther<s21::Set<int>> s_tree;
+  for (int k = 0; k < 20000; ++k) {
+    s_tree.insert_tree_multiset(k % 100);
+  }
+  ASSERT_TRUE(s_tree.is_valid_tree());
+  EXPECT_EQ(s_tree.size(), 20000U);
+  EXPECT_LE(s_tree.height(), 2 * std::log2(20001));
+  EXPECT_EQ(s_tree.count_multiset(s_tree.root(), 42), 200);
+  EXPECT_EQ(s_tree.count_multiset(s_tree.root(), 100), 0);
+  auto first = s_tree.search_multiset(42);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(s_tree.count_less(42), 42U * 200U);
+  EXPECT_EQ(s_tree.prev_tree(first)->values, 41);
+
+  s_tree.clear();
+  EXPECT_TRUE(s_tree.empty());
+  EXPECT_EQ(s_tree.search_multiset(42), nullptr);
+  s_tree.insert(7);
+  EXPECT_EQ(*s_tree.begin(), 7);
+}
+
+TEST(SetConstructors, StructuralCopy) {
+  TestOther<s21::Set<int>> s_tree;
+  for (int k = 0; k < 500; ++k) s_tree.insert((k * 37) % 500);
+  TestOther<s21::Set<int>> copy;
+  copy.insert(-1);
+  static_cast<s21::Set<int>&>(copy) = s_tree;
+  ASSERT_TRUE(copy.is_valid_tree());
+  EXPECT_EQ(copy.size(), s_tree.size());
+  EXPECT_EQ(copy.height(), s_tree.height());
+  for (size_t k = 0; k < s_tree.size(); ++k) {
+    EXPECT_EQ(*copy.nth(k), *s_tree.nth(k));
+    EXPECT_EQ(copy.nth(k).iter->color, s_tree.nth(k).iter->color);
+  }
+  EXPECT_EQ(*copy.begin(), 0);
+  EXPECT_EQ(*copy.nth(499), 499);
+  EXPECT_FALSE(copy.contains(-1));
+
+  copy.erase(copy.find(250));
+  EXPECT_TRUE(copy.contains(251));
+  EXPECT_TRUE(s_tree.contains(250));
+  EXPECT_TRUE(copy.is_valid_tree());
+}
+
+TEST(SetAlgebra, UnionIntersectionDifference) {
+  std::vector<int> x, y;
+  for (int k = 0; k < 300; k += 2) x.push_back(k);
+  for (int k = 0; k < 300; k += 3) y.push_back(k);
+  TestOther<s21::Set<int>> a, b;
+  a.assign_sorted(x.begin(), x.end());
+  b.assign_sorted(y.begin(), y.end());
+  auto valid = [](s21::Set<int>& result) {
+    TestOther<s21::Set<int>> checked;
+    checked.swap(result);
+    bool ok = checked.is_valid_tree();
+    checked.swap(result);
+    return ok;
+  };
+
+  std::vector<int> expected;
+  std::set_union(x.begin(), x.end(), y.begin(), y.end(),
+                 std::back_inserter(expected));
+  auto u = s21::set_union(a, b);
+  EXPECT_TRUE(valid(u));
+  ASSERT_EQ(u.size(), expected.size());
+  for (size_t k = 0; k < expected.size(); ++k) {
+    EXPECT_EQ(*u.nth(k), expected[k]);
+  }
+
+  expected.clear();
+  std::set_intersection(x.begin(), x.end(), y.begin(), y.end(),
+                        std::back_inserter(expected));
+  auto i = s21::set_intersection(a, b);
+  EXPECT_TRUE(valid(i));
+  ASSERT_EQ(i.size(), expected.size());
+  EXPECT_EQ(*i.nth(1), 6);
+
+  expected.clear();
+  std::set_difference(x.begin(), x.end(), y.begin(), y.end(),
+                      std::back_inserter(expected));
+  auto d = s21::set_difference(a, b);
+  EXPECT_TRUE(valid(d));
+  ASSERT_EQ(d.size(), expected.size());
+  EXPECT_EQ(*d.nth(expected.size() - 1), expected.back());
+  EXPECT_TRUE(s21::set_difference(b, b).empty());
+}
+
+TEST(SetModifiers, MergeRelinksNodes) {
+  // общий пул: узлы переходят между деревьями без перевыделения
+  s21::pool_allocator<int> pool;
+  TestOther<s21::Set<int>> s_tree(pool), other(pool);
+  for (int k = 0; k < 100; k += 2) s_tree.insert(k);
+  for (int k = 0; k < 100; k += 5) other.insert(k);
+  auto moved = other.find(15).iter;
+  auto kept = other.find(10).iter;
+  s_tree.merge(other);
+  EXPECT_TRUE(s_tree.is_valid_tree());
+  EXPECT_TRUE(other.is_valid_tree());
+  EXPECT_EQ(s_tree.size(), 60U);
+  EXPECT_EQ(other.size(), 10U);
+  EXPECT_EQ(s_tree.find(15).iter, moved);
+  EXPECT_EQ(other.find(10).iter, kept);
+
+  // разные пулы: s_tree берет блоки чужого пула, узлы тоже переходят
+  TestOther<s21::Set<int>> separate = {5, 7, 200};
+  auto foreign = separate.find(200).iter;
+  s_tree.merge(separate);
+  EXPECT_EQ(s_tree.find(200).iter, foreign);
+  EXPECT_TRUE(s_tree.is_valid_tree());
+  EXPECT_EQ(s_tree.size(), 62U);
+  EXPECT_EQ(separate.size(), 1U);
+  EXPECT_TRUE(separate.contains(5));
+
+  TestOther<s21::Set<int>> empty(pool);
+  empty.merge(s_tree);
+  EXPECT_TRUE(s_tree.empty());
+  EXPECT_EQ(empty.size(), 62U);
+  EXPECT_TRUE(empty.is_valid_tree());
+}
+
+TEST(MultisetLookup, CountAndEqualRange) {
+  std::vector<int> keys;
+  for (int k = 0; k < 1000; ++k) keys.push_back(k / 10);
+  TestOther<s21::Multiset<int>> sorted(keys.begin(), keys.end());
+  EXPECT_TRUE(sorted.is_valid_tree());
+  EXPECT_EQ(sorted.size(), 1000U);
+  EXPECT_EQ(sorted.count(42), 10U);
+  EXPECT_EQ(sorted.count(100), 0U);
+
+  std::reverse(keys.begin(), keys.end());
+  TestOther<s21::Multiset<int>> s_tree(keys.begin(), keys.end());
+  std::multiset<int> o_tree(keys.begin(), keys.end());
+  EXPECT_TRUE(s_tree.is_valid_tree());
+  EXPECT_EQ(s_tree.size(), o_tree.size());
+  auto range = s_tree.equal_range(7);
+  EXPECT_EQ(*range.first, 7);
+  EXPECT_EQ(*range.second, 8);
+  EXPECT_EQ(s_tree.count_less(7), 70U);
+  EXPECT_EQ(*s_tree.nth(75), 7);
+  EXPECT_TRUE(s_tree.find(-1) == s_tree.end());
+}
+
+TEST(MultisetModifiers, MergeAndErase) {
+  s21::pool_allocator<int> pool;
+  TestOther<s21::Multiset<int>> s_tree({1, 2, 2, 3}, pool);
+  TestOther<s21::Multiset<int>> other({2, 3, 3, 5}, pool);
+  s_tree.merge(other);
+  EXPECT_TRUE(s_tree.is_valid_tree());
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(s_tree.size(), 8U);
+  EXPECT_EQ(s_tree.count(2), 3U);
+  EXPECT_EQ(s_tree.count(3), 3U);
+
+  s21::Multiset<int> separate = {3, 4};
+  s_tree.merge(separate);
+  EXPECT_EQ(s_tree.count(3), 4U);
+  EXPECT_EQ(s_tree.erase(3), 4U);
+  EXPECT_EQ(s_tree.erase(3), 0U);
+  EXPECT_TRUE(s_tree.is_valid_tree());
+  EXPECT_EQ(s_tree.size(), 6U);
+
+  s21::Multiset<std::string> words;
+  words.emplace(3, 'a');
+  words.emplace("aaa");
+  words.insert(words.end(), "b");
+  EXPECT_EQ(words.count("aaa"), 2U);
+  EXPECT_EQ(*words.nth(2), "b");
+}
+
+TEST(SetIterator, ScanAfterMixedUpdates) {
+  // в сборке с S21_THREADED_TREE is_valid_tree сверяет и кольцо next/prev
+  TestOther<s21::Set<int>> s_tree;
+  std::set<int> o_tree;
+  for (int k = 0; k < 2000; ++k) {
+    int key = (k * 7919) % 1009;
+    if (k % 3 == 2) {
+      auto it = s_tree.find(key);
+      if (it != s_tree.end()) s_tree.erase(it);
+      o_tree.erase(key);
+    } else {
+      s_tree.insert(s_tree.end(), key);
+      o_tree.insert(key);
+    }
+  }
+  ASSERT_TRUE(s_tree.is_valid_tree());
+  ASSERT_EQ(s_tree.size(), o_tree.size());
+  auto oi = o_tree.begin();
+  for (auto si = s_tree.begin(); si != s_tree.end(); ++si, ++oi) {
+    EXPECT_EQ(*si, *oi);
+  }
+  auto ri = o_tree.rbegin();
+  auto si = s_tree.end();
+  for (--si; si != s_tree.end(); --si, ++ri) {
+    EXPECT_EQ(*si, *ri);
+  }
+
+  TestOther<s21::Set<int>> copy;
+  static_cast<s21::Set<int>&>(copy) = s_tree;
+  EXPECT_TRUE(copy.is_valid_tree());
+  TestOther<s21::Set<int>> built;
+  built.assign_sorted(o_tree.begin(), o_tree.end());
+  EXPECT_TRUE(built.is_valid_tree());
+  built.merge(copy);
+  EXPECT_TRUE(built.is_valid_tree());
+  EXPECT_EQ(*built.nth(built.size() - 1), *o_tree.rbegin());
+}
+
+TEST(BtreeSetModifiers, StringsMatchStdSet) {
+  s21::btree_set<std::string, std::less<>> s_tree;
+  std::set<std::string> o_tree;
+  for (int k = 0; k < 4000; ++k) {
+    std::string key = std::to_string(k * 7919 % 4001);
+    EXPECT_EQ(s_tree.insert(key).second, o_tree.insert(key).second);
+    if (k % 4 == 0) {
+      std::string gone = std::to_string(k * 31 % 4001);
+      EXPECT_EQ(s_tree.erase(gone), o_tree.erase(gone));
+    }
+  }
+  ASSERT_EQ(s_tree.size(), o_tree.size());
+  EXPECT_TRUE(std::equal(s_tree.begin(), s_tree.end(), o_tree.begin()));
+  std::string_view probe = "25";
+  EXPECT_EQ(*s_tree.lower_bound(probe), *o_tree.lower_bound("25"));
+  EXPECT_EQ(s_tree.contains(probe), o_tree.count("25") == 1);
+
+  s21::btree_set<int> ints = {5, 3, 9, 1, 3};
+  EXPECT_EQ(ints.size(), 4U);
+  EXPECT_EQ(*ints.begin(), 1);
+  EXPECT_TRUE(ints.find(4) == ints.end());
+  auto range = ints.equal_range(3);
+  EXPECT_EQ(*range.first, 3);
+  EXPECT_EQ(*range.second, 5);
+}
+
+TEST(FlatSetLookup, StringsAndBulkInsert) {
+  s21::flat_set<std::string, std::less<>> s_tree = {"pear", "apple", "fig"};
+  std::set<std::string> o_tree = {"pear", "apple", "fig"};
+  std::vector<std::string> batch;
+  for (int k = 0; k < 300; ++k) {
+    batch.push_back(std::to_string(k * 37 % 211));
+  }
+  s_tree.insert(batch.begin(), batch.end());
+  o_tree.insert(batch.begin(), batch.end());
+  ASSERT_EQ(s_tree.size(), o_tree.size());
+  EXPECT_TRUE(std::equal(s_tree.begin(), s_tree.end(), o_tree.begin()));
+
+  std::string_view probe = "fig";
+  EXPECT_TRUE(s_tree.contains(probe));
+  EXPECT_EQ(*s_tree.upper_bound(probe), "pear");
+  EXPECT_EQ(s_tree.rank("apple"), 211U);
+  EXPECT_EQ(s_tree.erase("fig"), 1U);
+  EXPECT_FALSE(s_tree.contains(probe));
+
+  auto keys = s_tree.extract();
+  EXPECT_TRUE(s_tree.empty());
+  EXPECT_EQ(keys.size(), 213U);
+  s_tree.replace(std::move(keys));
+  EXPECT_EQ(*s_tree.begin(), "0");
+  auto copy = s_tree;
+  copy.clear();
+  EXPECT_EQ(s_tree.size(), 213U);
+}
+
+TEST(UnorderedSetModifiers, InsertEraseAndCopy) {
+  s21::unordered_set<std::string> s_table = {"a", "b", "c", "a"};
+  EXPECT_EQ(s_table.size(), 3U);
+  for (int k = 0; k < 1000; ++k) {
+    s_table.insert(std::to_string(k));
+  }
+  for (int k = 0; k < 1000; k += 2) {
+    EXPECT_EQ(s_table.erase(std::to_string(k)), 1U);
+  }
+  EXPECT_EQ(s_table.size(), 503U);
+  EXPECT_TRUE(s_table.contains("999"));
+  EXPECT_FALSE(s_table.contains("998"));
+  EXPECT_TRUE(s_table.find("998") == s_table.end());
+
+  s21::unordered_set<std::string> copy(s_table);
+  s21::unordered_set<std::string> moved(std::move(s_table));
+  EXPECT_TRUE(s_table.empty());
+  EXPECT_EQ(moved.size(), copy.size());
+  std::size_t seen = 0;
+  for (const auto& key : moved) {
+    EXPECT_TRUE(copy.contains(key));
+    ++seen;
+  }
+  EXPECT_EQ(seen, 503U);
+  EXPECT_FALSE(moved.emplace(1, 'b').second);
+  EXPECT_TRUE(moved.emplace(4, 'x').second);
+}
+
 TEST(Test_1, constructor_int) {
   s21::stack<int> my_stack = {1, 2};
   std::stack<int> orig_stack;
@@ -1,8 +1,10 @@
 #ifndef TESTS_HPP_
 #define TESTS_HPP_
 
+#include <atomic>
 #include <exception>
 #include <iostream>
+#include <memory>
 
 #include "../s21_containers.h"
 
@@ -96,16 +98,106 @@ class ExceptionTest {
   int a;
 };
 
+// Аллокатор, считающий живые блоки всех своих rebind-копий
+inline std::atomic<long> counting_live_blocks{0};
+
+template <typename T>
+class CountingAllocator {
+ public:
+  using value_type = T;
+
+  CountingAllocator() = default;
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    ++counting_live_blocks;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    --counting_live_blocks;
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <typename U>
+  friend bool operator==(const CountingAllocator&,
+                         const CountingAllocator<U>&) noexcept {
+    return true;
+  }
+
+  template <typename U>
+  friend bool operator!=(const CountingAllocator&,
+                         const CountingAllocator<U>&) noexcept {
+    return false;
+  }
+};
+
 // Класс для проверки приватных функций тестируемого класса
 template <typename T>
 class TestOther : public T {
  public:
+  using T::T;
   TestOther() = default;
 
   ~TestOther() = default;
 
  public:
   void im() const noexcept { std::cout << "im TestOther" << std::endl; }
+
+  // для деревьев: высота и проверка инвариантов красно-черного дерева
+  template <typename Node>
+  static int height(const Node* node) {
+    if (node == nullptr) return 0;
+    return 1 + std::max(height(node->left), height(node->right));
+  }
+
+  int height() const { return height(this->root_); }
+
+  auto root() const { return this->root_; }
+
+  // возвращает черную высоту или -1, если инварианты нарушены
+  template <typename Node>
+  static int black_height(const Node* node) {
+    if (node == nullptr) return 1;
+    if (node->color == s21::Red &&
+        ((node->left && node->left->color == s21::Red) ||
+         (node->right && node->right->color == s21::Red))) {
+      return -1;
+    }
+    if ((node->left && node->left->parent != node) ||
+        (node->right && node->right->parent != node)) {
+      return -1;
+    }
+    std::size_t size = 1 + (node->left ? node->left->size : 0) +
+                       (node->right ? node->right->size : 0);
+    int l = black_height(node->left);
+    int r = black_height(node->right);
+    if (l < 0 || l != r || size != node->size) return -1;
+    return l + (node->color == s21::Black ? 1 : 0);
+  }
+
+  bool is_valid_tree() const {
+    if (this->root_ == nullptr) return this->size() == 0;
+    return this->root_->color == s21::Black &&
+           this->root_->size == this->size() &&
+           black_height(this->root_) > 0 && is_threaded();
+  }
+
+  // кольцо next/prev совпадает с обходом по родителям
+  bool is_threaded() const {
+#ifdef S21_THREADED_TREE
+    auto before = this->end_;
+    for (auto node = this->end_->right; node; node = this->next_tree(node)) {
+      if (before->next != node || node->prev != before) return false;
+      before = node;
+    }
+    return before->next == this->end_ && this->end_->prev == before;
+#else
+    return true;
+#endif
+  }
 };
 
 #endif
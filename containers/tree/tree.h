@@ -1,9 +1,14 @@
 #ifndef S21_TREE_H_
 #define S21_TREE_H_
 
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
 
 #include "../set-map/tree_iterator.h"
+#include "../utils/defines.h"
+#include "../utils/pool_allocator.h"
 
 namespace s21 {
     // declaration
@@ -13,267 +18,1232 @@ namespace s21 {
     template <typename Key, typename T>
     class tree_el_;
 
+    // element stored in a node: a pair for Map, the bare key for Set (T = void)
+    template <typename Key, typename T>
+    struct tree_value_ {
+        using type = std::pair<Key, T>;
+        static const Key& key(const type& value) noexcept { return value.first; }
+    };
+
+    template <typename Key>
+    struct tree_value_<Key, void> {
+        using type = Key;
+        static const Key& key(const type& value) noexcept { return value; }
+    };
+
+    // allocators that can hand out the next n nodes contiguously
+    template <typename A, typename = void>
+    struct has_reserve_ : std::false_type {};
+
+    template <typename A>
+    struct has_reserve_<A, std::void_t<decltype(std::declval<A&>().reserve(
+        size_t()))>> : std::true_type {};
+
+    // allocators that can take over the nodes of an unequal copy
+    template <typename A, typename = void>
+    struct has_adopt_ : std::false_type {};
+
+    template <typename A>
+    struct has_adopt_<A, std::void_t<decltype(std::declval<A&>().adopt(
+        std::declval<const A&>()))>> : std::true_type {};
+
     // tree element
     enum TreeColor { Black, Red };
     template <typename Key, typename T>
     class tree_el_ {
     public:
-        std::pair<Key, T> values;
+        using value_type = typename tree_value_<Key, T>::type;
+
+        // constructed by the tree after the links, never in the end_ sentinel
+        union {
+            value_type values;
+        };
         TreeColor color;
         tree_el_* parent;
         tree_el_* left;
         tree_el_* right;
+        // number of elements in the subtree rooted at this node
+        size_t size;
+#ifdef S21_THREADED_TREE
+        // in-order neighbours, the ring is closed through the end_ sentinel
+        tree_el_* next = nullptr;
+        tree_el_* prev = nullptr;
+#endif
+
+        tree_el_(TreeColor c, tree_el_<Key, T>* p, tree_el_<Key, T>* l,
+            tree_el_<Key, T>* r)
+            : color(c), parent(p), left(l), right(r), size(1) {};
+        ~tree_el_() {};
 
-        tree_el_() : tree_el_(Key(), T()) {};
-        tree_el_(std::pair<Key, T> val, TreeColor c, tree_el_<Key, T>* p,
-            tree_el_<Key, T>* l, tree_el_<Key, T>* r)
-            : values(val), color(c), parent(p), left(l), right(r) {};
+        const Key& key() const noexcept { return tree_value_<Key, T>::key(values); }
     };
 
-    // Tree
+    // subtree aggregate kept in the mapped value, see augmented_map.h;
+    // plain trees skip every refresh at compile time
     template <typename Key, typename T>
+    struct tree_augment_ {
+        static constexpr bool enabled = false;
+        static void update(tree_el_<Key, T>*) noexcept {}
+    };
+
+    template <typename Key, typename T, typename Compare, typename Allocator>
+    class Tree;
+
+    // owns one element taken out of a tree together with its node; the key
+    // may be changed until the node is inserted again
+    template <typename Key, typename T, typename Allocator>
+    class tree_node_handle_ {
+        using node_allocator_type = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<tree_el_<Key, T>>;
+        using node_traits = std::allocator_traits<node_allocator_type>;
+
+    public:
+        using key_type = Key;
+        using allocator_type = Allocator;
+
+        tree_node_handle_() noexcept = default;
+
+        tree_node_handle_(tree_node_handle_&& other) noexcept
+            : node_(std::exchange(other.node_, nullptr)),
+            alloc_(std::move(other.alloc_)) {
+            other.alloc_.reset();
+        }
+
+        tree_node_handle_& operator=(tree_node_handle_&& other) noexcept {
+            if (this != &other) {
+                reset();
+                node_ = std::exchange(other.node_, nullptr);
+                alloc_ = std::move(other.alloc_);
+                other.alloc_.reset();
+            }
+            return *this;
+        }
+
+        ~tree_node_handle_() { reset(); }
+
+        bool empty() const noexcept { return node_ == nullptr; }
+
+        explicit operator bool() const noexcept { return node_ != nullptr; }
+
+        allocator_type get_allocator() const { return allocator_type(*alloc_); }
+
+        Key& key() const noexcept {
+            if constexpr (std::is_void_v<T>) {
+                return node_->values;
+            }
+            else {
+                return node_->values.first;
+            }
+        }
+
+        // Set handles: the element is the key
+        template <typename U = T, typename = std::enable_if_t<std::is_void_v<U>>>
+        Key& value() const noexcept {
+            return node_->values;
+        }
+
+        template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+        U& mapped() const noexcept {
+            return node_->values.second;
+        }
+
+        void swap(tree_node_handle_& other) noexcept {
+            std::swap(node_, other.node_);
+            std::swap(alloc_, other.alloc_);
+        }
+
+    private:
+        template <typename, typename, typename, typename>
+        friend class Tree;
+
+        tree_node_handle_(tree_el_<Key, T>* node,
+            const node_allocator_type& alloc) noexcept
+            : node_(node), alloc_(alloc) {}
+
+        void reset() noexcept {
+            if (node_) {
+                node_traits::destroy(*alloc_, std::addressof(node_->values));
+                node_traits::destroy(*alloc_, node_);
+                node_traits::deallocate(*alloc_, node_, 1);
+                node_ = nullptr;
+            }
+            alloc_.reset();
+        }
+
+        tree_el_<Key, T>* node_ = nullptr;
+        // engaged exactly when node_ is set
+        std::optional<node_allocator_type> alloc_;
+    };
+
+    // result of inserting a node handle: on a clash the handle keeps the node
+    template <typename Iterator, typename NodeType>
+    struct tree_insert_return_ {
+        Iterator position;
+        bool inserted;
+        NodeType node;
+    };
+
+    // Tree
+    template <typename Key, typename T, typename Compare = std::less<Key>,
+        typename Allocator = pool_allocator<std::pair<const Key, T>>>
     class Tree {
     protected:
+        using node_allocator_type = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<tree_el_<Key, T>>;
+        using node_traits = std::allocator_traits<node_allocator_type>;
+
         tree_el_<Key, T>* root_;
         tree_el_<Key, T>* end_;
+        size_t size_;
+        node_allocator_type node_allocator_;
+        Compare compare_;
 
     public:
         using size_type = size_t;
+        using key_compare = Compare;
+        using allocator_type = Allocator;
         using iterator = TreeIterator<Key, T>;
+        using node_value_type = typename tree_el_<Key, T>::value_type;
+        using node_type = tree_node_handle_<Key, T, Allocator>;
 
         // constructor
-        Tree() : root_(nullptr), end_(nullptr) {}
+        Tree() : Tree(Allocator()) {}
+
+        explicit Tree(const Allocator& alloc) : Tree(Compare(), alloc) {}
+
+        explicit Tree(const Compare& compare, const Allocator& alloc = Allocator())
+            : root_(nullptr), end_(nullptr), size_(0), node_allocator_(alloc),
+            compare_(compare) {}
+
+        ~Tree() { clear_tree(); }
+
+        allocator_type get_allocator() const {
+            return allocator_type(node_allocator_);
+        }
+
+        key_compare key_comp() const { return compare_; }
 
-        Tree(std::initializer_list<std::pair<const Key, T>> const& items) {
+        //  node allocation
+        template <typename... Args>
+        tree_el_<Key, T>* create_node(Args&&... args) {
+            tree_el_<Key, T>* node = node_traits::allocate(node_allocator_, 1);
+            node_traits::construct(node_allocator_, node, Red, nullptr, nullptr,
+                nullptr);
+            try {
+                node_traits::construct(node_allocator_,
+                    std::addressof(node->values), std::forward<Args>(args)...);
+            }
+            catch (...) {
+                node_traits::destroy(node_allocator_, node);
+                node_traits::deallocate(node_allocator_, node, 1);
+                THROW_FURTHER;
+            }
+            return node;
+        }
+
+        void destroy_node(tree_el_<Key, T>* node) {
+            node_traits::destroy(node_allocator_, std::addressof(node->values));
+            node_traits::destroy(node_allocator_, node);
+            node_traits::deallocate(node_allocator_, node, 1);
+        }
+
+        // the sentinel only carries links: left is the max, right is the min
+        tree_el_<Key, T>* create_end(tree_el_<Key, T>* node) {
+            tree_el_<Key, T>* end = node_traits::allocate(node_allocator_, 1);
+            node_traits::construct(node_allocator_, end, Red, nullptr, node, node);
+            return end;
+        }
+
+        void destroy_end(tree_el_<Key, T>* end) {
+            node_traits::destroy(node_allocator_, end);
+            node_traits::deallocate(node_allocator_, end, 1);
+        }
+
+        //  true when nodes made by other may be linked here and freed by us
+        bool can_relink(const node_allocator_type& other) {
+            if (node_allocator_ == other) return true;
+            if constexpr (has_adopt_<node_allocator_type>::value) {
+                return node_allocator_.adopt(other);
+            }
+            else {
+                return false;
+            }
+        }
+
+        void reserve_nodes(size_t count) {
+            if constexpr (has_reserve_<node_allocator_type>::value) {
+                node_allocator_.reserve(count);
+            }
+        }
+
+        //  whole-tree operations shared by Set and Map
+        //  O(n) teardown, no rebalancing
+        void clear_tree() noexcept {
+            destroy_subtree(root_);
             root_ = nullptr;
+            size_ = 0;
+            if (end_) destroy_end(end_);
             end_ = nullptr;
-            for (auto i = items.begin(); i != items.end(); ++i) {
-                insert_tree(*i);
+        }
+
+        //  frees a detached subtree in O(n) without recursion: left children are
+        //  rotated up until the current node has none, then it goes
+        void destroy_subtree(tree_el_<Key, T>* node) noexcept {
+            while (node) {
+                if (node->left) {
+                    tree_el_<Key, T>* left = node->left;
+                    node->left = left->right;
+                    left->right = node;
+                    node = left;
+                }
+                else {
+                    tree_el_<Key, T>* next = node->right;
+                    destroy_node(node);
+                    node = next;
+                }
             }
         }
 
-        //  tree capacity
-        bool empty() const noexcept { return size() == 0; }
+        //  clones the shape and colors of other in one walk, nodes come from a
+        //  single reserved batch; the old contents are dropped only on success
+        void copy_tree(const Tree& other) {
+            if (this == &other) return;
+            compare_ = other.compare_;
+            tree_el_<Key, T>* root = nullptr;
+            tree_el_<Key, T>* min = nullptr;
+            tree_el_<Key, T>* max = nullptr;
+            if (!other.empty()) {
+                reserve_nodes(other.size_);
+                try {
+                    root = clone_node(other.root_, nullptr);
+                    tree_el_<Key, T>* from = other.root_;
+                    tree_el_<Key, T>* to = root;
+                    while (true) {
+                        if (from == other.end_->right) min = to;
+                        if (from == other.end_->left) max = to;
+                        if (from->left && !to->left) {
+                            to->left = clone_node(from->left, to);
+                            from = from->left;
+                            to = to->left;
+                        }
+                        else if (from->right && !to->right) {
+                            to->right = clone_node(from->right, to);
+                            from = from->right;
+                            to = to->right;
+                        }
+                        else if (from != other.root_) {
+                            from = from->parent;
+                            to = to->parent;
+                        }
+                        else {
+                            break;
+                        }
+                    }
+                    if (end_ == nullptr) end_ = create_end(nullptr);
+                }
+                catch (...) {
+                    destroy_subtree(root);
+                    THROW_FURTHER;
+                }
+            }
+            destroy_subtree(root_);
+            root_ = root;
+            size_ = other.size_;
+            if (root) {
+                end_->right = min;
+                end_->left = max;
+#ifdef S21_THREADED_TREE
+                tree_el_<Key, T>* before = end_;
+                for (tree_el_<Key, T>* node = min; node; node = next_tree(node)) {
+                    thread_between(before, node, end_);
+                    before = node;
+                }
+#endif
+            }
+            else if (end_) {
+                destroy_end(end_);
+                end_ = nullptr;
+            }
+        }
+
+        tree_el_<Key, T>* clone_node(const tree_el_<Key, T>* from,
+            tree_el_<Key, T>* parent) {
+            tree_el_<Key, T>* node = create_node(from->values);
+            node->color = from->color;
+            node->parent = parent;
+            node->size = from->size;
+            return node;
+        }
 
-        size_type size() const noexcept {
-            auto size = counter(root_);
-            return size;
+        void move_tree(Tree& other) {
+            if (this == &other) return;
+            clear_tree();
+            compare_ = other.compare_;
+            if constexpr (!node_traits::propagate_on_container_move_assignment::value) {
+                if (node_allocator_ != other.node_allocator_) {
+                    // nodes cannot change hands between foreign allocators
+                    for (auto node = other.end_ ? other.end_->right : nullptr;
+                        node != nullptr; node = next_tree(node)) {
+                        insert_tree(std::move(node->values));
+                    }
+                    other.clear_tree();
+                    return;
+                }
+            }
+            else {
+                node_allocator_ = other.node_allocator_;
+            }
+            root_ = std::exchange(other.root_, nullptr);
+            end_ = std::exchange(other.end_, nullptr);
+            size_ = std::exchange(other.size_, 0);
         }
 
+        void swap_tree(Tree& other) {
+            std::swap(root_, other.root_);
+            std::swap(end_, other.end_);
+            std::swap(size_, other.size_);
+            std::swap(compare_, other.compare_);
+            if constexpr (node_traits::propagate_on_container_swap::value) {
+                std::swap(node_allocator_, other.node_allocator_);
+            }
+        }
+
+        //  tree capacity
+        bool empty() const noexcept { return size_ == 0; }
+
+        size_type size() const noexcept { return size_; }
+
         //  dop function
-        int counter(tree_el_<Key, T>* cur_el) const {
-            if (cur_el == nullptr) {
-                return 0;
+        static size_type subtree_size(const tree_el_<Key, T>* node) noexcept {
+            return node ? node->size : 0;
+        }
+
+        static void update_size(tree_el_<Key, T>* node) noexcept {
+            node->size = 1 + subtree_size(node->left) + subtree_size(node->right);
+        }
+
+        //  recomputes the aggregates from node up to the root, O(height)
+        static void refresh_path_tree(tree_el_<Key, T>* node) noexcept {
+            if constexpr (tree_augment_<Key, T>::enabled) {
+                for (; node != nullptr; node = node->parent) {
+                    tree_augment_<Key, T>::update(node);
+                }
             }
-            return 1 + counter(cur_el->left) + counter(cur_el->right);
         }
 
-        //  for multiset
-        int count_multiset(tree_el_<Key, T>* node, const Key& key) const {
-            if (node != NULL) {
-                if (node->values.first == key) {
-                    return 1 + count_multiset(node->left, key) +
-                        count_multiset(node->right, key);
+        //  order statistics
+        tree_el_<Key, T>* nth_tree(size_type k) const noexcept {
+            tree_el_<Key, T>* node = root_;
+            while (node != nullptr) {
+                size_type left = subtree_size(node->left);
+                if (k < left) {
+                    node = node->left;
+                }
+                else if (k == left) {
+                    return node;
+                }
+                else {
+                    k -= left + 1;
+                    node = node->right;
+                }
+            }
+            return nullptr;
+        }
+
+        //  lookups are templates so that a transparent Compare can take any K
+        template <typename K>
+        size_type count_less_tree(const K& key) const {
+            size_type count = 0;
+            tree_el_<Key, T>* node = root_;
+            while (node != nullptr) {
+                if (compare_(node->key(), key)) {
+                    count += subtree_size(node->left) + 1;
+                    node = node->right;
+                }
+                else {
+                    node = node->left;
                 }
+            }
+            return count;
+        }
 
-                return count_multiset(node->left, key) + count_multiset(node->right, key);
+        //  in-order neighbours, nullptr past the ends
+        static tree_el_<Key, T>* next_tree(tree_el_<Key, T>* node) noexcept {
+            if (node->right) {
+                node = node->right;
+                while (node->left) node = node->left;
+                return node;
             }
+            while (node->parent && node == node->parent->right) {
+                node = node->parent;
+            }
+            return node->parent;
+        }
 
-            return 0;
+        static tree_el_<Key, T>* prev_tree(tree_el_<Key, T>* node) noexcept {
+            if (node->left) {
+                node = node->left;
+                while (node->right) node = node->right;
+                return node;
+            }
+            while (node->parent && node == node->parent->left) {
+                node = node->parent;
+            }
+            return node->parent;
         }
 
-        //  tree balancing & insert_tree
-        void insert_tree(tree_el_<Key, T>* root_, tree_el_<Key, T>* new_node) {
-            if (new_node->values.first <= root_->values.first) {
-                if (root_->left == nullptr) {
-                    root_->left = new_node;
-                    new_node->parent = root_;
+#ifdef S21_THREADED_TREE
+        //  puts node into the next/prev ring between two neighbours
+        static void thread_between(tree_el_<Key, T>* before,
+            tree_el_<Key, T>* node, tree_el_<Key, T>* after) noexcept {
+            node->prev = before;
+            node->next = after;
+            before->next = node;
+            after->prev = node;
+        }
+#endif
+
+        //  single-descent unique insert
+        struct insert_pos_ {
+            tree_el_<Key, T>* node;    // element with an equal key, if any
+            tree_el_<Key, T>* parent;  // otherwise the new node hangs here
+            bool left;
+        };
+
+        insert_pos_ find_insert_pos(const Key& key) const {
+            if (root_ == nullptr) return { nullptr, nullptr, true };
+            // keys arriving in ascending order go straight after the maximum
+            if (compare_(end_->left->key(), key)) {
+                return { nullptr, end_->left, false };
+            }
+
+            tree_el_<Key, T>* node = root_;
+            while (true) {
+                if (compare_(key, node->key())) {
+                    if (node->left == nullptr) return { nullptr, node, true };
+                    node = node->left;
+                }
+                else if (compare_(node->key(), key)) {
+                    if (node->right == nullptr) return { nullptr, node, false };
+                    node = node->right;
                 }
                 else {
-                    insert_tree(root_->left, new_node);
+                    return { node, nullptr, false };
+                }
+            }
+        }
+
+        //  O(1) comparisons when key belongs right next to hint
+        insert_pos_ find_insert_pos(tree_el_<Key, T>* hint, const Key& key) const {
+            if (root_ == nullptr || hint == nullptr || hint == end_) {
+                return find_insert_pos(key);
+            }
+            if (compare_(key, hint->key())) {
+                if (hint == end_->right) return { nullptr, hint, true };
+                tree_el_<Key, T>* before = prev_tree(hint);
+                if (compare_(before->key(), key)) {
+                    if (before->right == nullptr) return { nullptr, before, false };
+                    return { nullptr, hint, true };
+                }
+            }
+            else if (compare_(hint->key(), key)) {
+                if (hint == end_->left) return { nullptr, hint, false };
+                tree_el_<Key, T>* after = next_tree(hint);
+                if (compare_(key, after->key())) {
+                    if (hint->right == nullptr) return { nullptr, hint, false };
+                    return { nullptr, after, true };
+                }
+            }
+            else {
+                return { hint, nullptr, false };
+            }
+            return find_insert_pos(key);
+        }
+
+        //  hang a fresh node at pos and rebalance, the node is freed on failure
+        tree_el_<Key, T>* link_node(tree_el_<Key, T>* node, const insert_pos_& pos) {
+            node->parent = pos.parent;
+            if (pos.parent == nullptr) {
+                if (end_ == nullptr) {
+                    try {
+                        end_ = create_end(node);
+                    }
+                    catch (...) {
+                        destroy_node(node);
+                        THROW_FURTHER;
+                    }
                 }
+                root_ = node;
+                end_->left = node;
+                end_->right = node;
             }
-            else if (new_node->values.first > root_->values.first) {
-                if (root_->right == nullptr) {
-                    root_->right = new_node;
-                    new_node->parent = root_;
+            else {
+                if (pos.left) {
+                    pos.parent->left = node;
+                    if (pos.parent == end_->right) end_->right = node;
                 }
                 else {
-                    insert_tree(root_->right, new_node);
+                    pos.parent->right = node;
+                    if (pos.parent == end_->left) end_->left = node;
+                }
+                for (auto p = pos.parent; p != nullptr; p = p->parent) {
+                    ++p->size;
                 }
             }
-            balance(new_node);
+            refresh_path_tree(node);
+#ifdef S21_THREADED_TREE
+            if (pos.parent == nullptr) {
+                thread_between(end_, node, end_);
+            }
+            else if (pos.left) {
+                thread_between(pos.parent->prev, node, pos.parent);
+            }
+            else {
+                thread_between(pos.parent, node, pos.parent->next);
+            }
+#endif
+            ++size_;
+            balance(node);
+            return node;
         }
 
-        void insert_tree(const std::pair<Key, T> val) {
-            tree_el_<Key, T>* new_node =
-                new tree_el_<Key, T>(val, Red, nullptr, nullptr, nullptr);
+        std::pair<tree_el_<Key, T>*, bool> insert_unique_tree(node_value_type val) {
+            return emplace_key_tree(nullptr, tree_value_<Key, T>::key(val),
+                std::move(val));
+        }
 
-            if (empty()) {
-                root_ = new_node;
-                if (end_ == nullptr) {
-                    end_ = new tree_el_<Key, T>(val, Red, nullptr, new_node, new_node);
+        tree_el_<Key, T>* insert_unique_tree(tree_el_<Key, T>* hint,
+            node_value_type val) {
+            return emplace_key_tree(hint, tree_value_<Key, T>::key(val),
+                std::move(val)).first;
+        }
+
+        //  key known up front: the value is built in the node only if it is absent
+        template <typename... Args>
+        std::pair<tree_el_<Key, T>*, bool> emplace_key_tree(tree_el_<Key, T>* hint,
+            const Key& key, Args&&... args) {
+            insert_pos_ pos = find_insert_pos(hint, key);
+            if (pos.node) return { pos.node, false };
+            return { link_node(create_node(std::forward<Args>(args)...), pos), true };
+        }
+
+        //  key unknown until the value exists: build it, drop it on a clash
+        template <typename... Args>
+        std::pair<tree_el_<Key, T>*, bool> emplace_unique_tree(
+            tree_el_<Key, T>* hint, Args&&... args) {
+            tree_el_<Key, T>* node = create_node(std::forward<Args>(args)...);
+            insert_pos_ pos = find_insert_pos(hint, node->key());
+            if (pos.node) {
+                destroy_node(node);
+                return { pos.node, false };
+            }
+            return { link_node(node, pos), true };
+        }
+
+        //  bulk insert: ascending input into an empty tree is built in O(n);
+        //  without unique, equal keys are kept in input order
+        template <typename InputIt>
+        void insert_range_tree(InputIt first, InputIt last, bool unique = true) {
+            if (!empty()) {
+                for (; first != last; ++first) {
+                    insert_any_tree(unique, *first);
+                }
+                return;
+            }
+            using category = typename std::iterator_traits<InputIt>::iterator_category;
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+                reserve_nodes(static_cast<size_t>(std::distance(first, last)));
+            }
+
+            // ascending prefix kept as a chain through the right links
+            chain_ chain;
+            tree_el_<Key, T>* node = nullptr;
+            try {
+                for (; first != last; ++first) {
+                    node = create_node(*first);
+                    if (chain.tail && compare_(node->key(), chain.tail->key())) {
+                        break;
+                    }
+                    if (unique && chain.tail &&
+                        !compare_(chain.tail->key(), node->key())) {
+                        destroy_node(node);
+                        node = nullptr;
+                        continue;
+                    }
+                    chain.push(node);
+                    node = nullptr;
                 }
             }
+            catch (...) {
+                if (node) destroy_node(node);
+                destroy_chain(chain);
+                THROW_FURTHER;
+            }
+            try {
+                assign_chain_tree(chain);
+            }
+            catch (...) {
+                if (node) destroy_node(node);
+                THROW_FURTHER;
+            }
+
+            // out-of-order input: the rest goes through the regular insert
+            if (node) {
+                insert_pos_ pos = unique ? find_insert_pos(node->key())
+                    : find_insert_equal_pos(node->key());
+                if (pos.node) {
+                    destroy_node(node);
+                }
+                else {
+                    link_node(node, pos);
+                }
+                for (++first; first != last; ++first) {
+                    insert_any_tree(unique, *first);
+                }
+            }
+        }
+
+        template <typename V>
+        void insert_any_tree(bool unique, V&& value) {
+            if (unique) {
+                emplace_unique_tree(end_, std::forward<V>(value));
+            }
             else {
-                insert_tree(root_, new_node);
+                emplace_equal_tree(end_, std::forward<V>(value));
+            }
+        }
+
+        //  sorted nodes linked through right, the input of build_sorted_tree
+        struct chain_ {
+            tree_el_<Key, T>* head = nullptr;
+            tree_el_<Key, T>* tail = nullptr;
+            size_type count = 0;
 
-                if (new_node->values.first > end_->left->values.first) {
-                    end_->left = new_node;
+            void push(tree_el_<Key, T>* node) noexcept {
+                (tail ? tail->right : head) = node;
+                tail = node;
+                node->left = node->right = nullptr;
+                ++count;
+            }
+        };
+
+        void destroy_chain(chain_& chain) noexcept {
+            while (chain.head) {
+                tree_el_<Key, T>* next = chain.head->right;
+                destroy_node(chain.head);
+                chain.head = next;
+            }
+            chain = chain_();
+        }
+
+        //  unlinks every node into an ascending chain in O(n), end_ is kept
+        chain_ detach_chain_tree() noexcept {
+            chain_ chain;
+            chain.count = size_;
+            tree_el_<Key, T>** link = &chain.head;
+            tree_el_<Key, T>* rest = root_;
+            while (rest) {
+                if (rest->left == nullptr) {
+                    *link = chain.tail = rest;
+                    link = &rest->right;
+                    rest = rest->right;
                 }
-                if (new_node->values.first < end_->right->values.first) {
-                    end_->right = new_node;
+                else {
+                    tree_el_<Key, T>* left = rest->left;
+                    rest->left = left->right;
+                    left->right = rest;
+                    rest = left;
                 }
             }
-            root_->color = Black;
+            root_ = nullptr;
+            size_ = 0;
+            return chain;
         }
-        // for Set
-        void insert_tree(const Key k) {
-            std::pair<Key, T> val = { k, 0 };
-            tree_el_<Key, T>* new_node =
-                new tree_el_<Key, T>(val, Red, nullptr, nullptr, nullptr);
 
-            if (empty()) {
-                root_ = new_node;
-                if (end_ == nullptr) {
-                    end_ = new tree_el_<Key, T>(val, Red, nullptr, new_node, new_node);
+        //  the tree must hold no nodes; takes the chain over, frees it on failure
+        void assign_chain_tree(chain_& chain) {
+            if (chain.count == 0) {
+                if (end_) destroy_end(end_);
+                end_ = nullptr;
+                return;
+            }
+            if (end_ == nullptr) {
+                try {
+                    end_ = create_end(nullptr);
+                }
+                catch (...) {
+                    destroy_chain(chain);
+                    THROW_FURTHER;
                 }
             }
-            else {
-                insert_tree(root_, new_node);
+            end_->right = chain.head;
+            end_->left = chain.tail;
+            size_ = chain.count;
+#ifdef S21_THREADED_TREE
+            tree_el_<Key, T>* before = end_;
+            for (tree_el_<Key, T>* node = chain.head; node; node = node->right) {
+                thread_between(before, node, end_);
+                before = node;
+            }
+#endif
+            root_ = build_sorted_tree(chain.head, chain.count, 0, red_depth(chain.count));
+            root_->parent = nullptr;
+            chain = chain_();
+        }
 
-                if (new_node->values.first > end_->left->values.first) {
-                    end_->left = new_node;
+        //  one in-order walk of a and b, keeps the keys found only in a, in both
+        //  (the element of a) or only in b; O(|a| + |b|)
+        void assign_set_operation_tree(const Tree& a, const Tree& b,
+            bool only_a, bool both, bool only_b) {
+            clear_tree();
+            chain_ chain;
+            try {
+                tree_el_<Key, T>* x = a.empty() ? nullptr : a.end_->right;
+                tree_el_<Key, T>* y = b.empty() ? nullptr : b.end_->right;
+                while (x || y) {
+                    const tree_el_<Key, T>* pick = nullptr;
+                    if (y == nullptr || (x && compare_(x->key(), y->key()))) {
+                        if (only_a) pick = x;
+                        x = next_tree(x);
+                    }
+                    else if (x == nullptr || compare_(y->key(), x->key())) {
+                        if (only_b) pick = y;
+                        y = next_tree(y);
+                    }
+                    else {
+                        if (both) pick = x;
+                        x = next_tree(x);
+                        y = next_tree(y);
+                    }
+                    if (pick) chain.push(create_node(pick->values));
                 }
-                if (new_node->values.first < end_->right->values.first) {
-                    end_->right = new_node;
+            }
+            catch (...) {
+                destroy_chain(chain);
+                THROW_FURTHER;
+            }
+            assign_chain_tree(chain);
+        }
+
+        //  moves the elements of other with new keys here in O(n + m), or all of
+        //  them without unique (equal keys: ours first); nodes are relinked when
+        //  can_relink allows it and rebuilt otherwise
+        void merge_tree(Tree& other, bool unique = true) {
+            if (this == &other || other.empty()) return;
+            const bool relink = can_relink(other.node_allocator_);
+            if (end_ == nullptr) end_ = create_end(nullptr);
+            chain_ mine = detach_chain_tree();
+            chain_ theirs = other.detach_chain_tree();
+            chain_ kept, dropped;
+            tree_el_<Key, T>* x = mine.head;
+            tree_el_<Key, T>* y = theirs.head;
+            try {
+                while (x || y) {
+                    if (y == nullptr || (x && (unique ? compare_(x->key(), y->key())
+                        : !compare_(y->key(), x->key())))) {
+                        tree_el_<Key, T>* next = x->right;
+                        kept.push(x);
+                        x = next;
+                    }
+                    else if (x == nullptr || compare_(y->key(), x->key())) {
+                        tree_el_<Key, T>* next = y->right;
+                        if (relink) {
+                            kept.push(y);
+                        }
+                        else {
+                            kept.push(create_node(std::move(y->values)));
+                            other.destroy_node(y);
+                        }
+                        y = next;
+                    }
+                    else {
+                        tree_el_<Key, T>* next_x = x->right;
+                        tree_el_<Key, T>* next_y = y->right;
+                        kept.push(x);
+                        dropped.push(y);
+                        x = next_x;
+                        y = next_y;
+                    }
                 }
             }
-            root_->color = Black;
+            catch (...) {
+                //  nothing is lost: the unvisited tails stay with their owners
+                for (tree_el_<Key, T>* next; x; x = next) {
+                    next = x->right;
+                    kept.push(x);
+                }
+                for (tree_el_<Key, T>* next; y; y = next) {
+                    next = y->right;
+                    dropped.push(y);
+                }
+                assign_chain_tree(kept);
+                other.assign_chain_tree(dropped);
+                THROW_FURTHER;
+            }
+            assign_chain_tree(kept);
+            other.assign_chain_tree(dropped);
         }
 
-        // for multiset
-        void insert_tree_multiset(tree_el_<Key, T>* root_,
-            tree_el_<Key, T>* new_node) {
-            if (new_node->values.first <= root_->values.first) {
-                if (root_->left == nullptr) {
-                    root_->left = new_node;
-                    new_node->parent = root_;
+        //  levels above this depth are full: nodes on it are red, the rest black
+        static size_type red_depth(size_type count) noexcept {
+            size_type depth = 0;
+            while (((count + 1) >> (depth + 1)) != 0) ++depth;
+            return depth;
+        }
+
+        //  balanced tree of the first count chain nodes, head moves past them
+        static tree_el_<Key, T>* build_sorted_tree(tree_el_<Key, T>*& head,
+            size_type count, size_type depth, size_type red) {
+            if (count == 0) return nullptr;
+            tree_el_<Key, T>* left = build_sorted_tree(head, count / 2, depth + 1, red);
+            tree_el_<Key, T>* node = head;
+            head = head->right;
+            node->left = left;
+            if (left) left->parent = node;
+            node->right = build_sorted_tree(head, count - count / 2 - 1, depth + 1, red);
+            if (node->right) node->right->parent = node;
+            node->size = count;
+            tree_augment_<Key, T>::update(node);
+            node->color = depth == red ? Red : Black;
+            return node;
+        }
+
+        //  for multiset: equal keys inside the subtree of node, O(height)
+        int count_multiset(tree_el_<Key, T>* node, const Key& key) const {
+            return static_cast<int>(count_before(node, key, true) -
+                count_before(node, key, false));
+        }
+
+        //  elements with an equal key, O(height)
+        template <typename K>
+        size_type count_tree(const K& key) const {
+            return count_before(root_, key, true) - count_before(root_, key, false);
+        }
+
+        //  elements of the subtree below key, or not above it when inclusive
+        template <typename K>
+        size_type count_before(tree_el_<Key, T>* node, const K& key,
+            bool inclusive) const {
+            size_type count = 0;
+            while (node != nullptr) {
+                if (inclusive ? compare_(key, node->key())
+                    : !compare_(node->key(), key)) {
+                    node = node->left;
                 }
                 else {
-                    insert_tree_multiset(root_->left, new_node);
+                    count += subtree_size(node->left) + 1;
+                    node = node->right;
                 }
             }
-            else if (new_node->values.first > root_->values.first) {
-                if (root_->right == nullptr) {
-                    root_->right = new_node;
-                    new_node->parent = root_;
+            return count;
+        }
+
+        //  position after the last equal key, so equal keys keep insertion order
+        insert_pos_ find_insert_equal_pos(const Key& key) const {
+            if (root_ == nullptr) return { nullptr, nullptr, true };
+            if (!compare_(key, end_->left->key())) {
+                return { nullptr, end_->left, false };
+            }
+
+            tree_el_<Key, T>* node = root_;
+            while (true) {
+                if (compare_(key, node->key())) {
+                    if (node->left == nullptr) return { nullptr, node, true };
+                    node = node->left;
                 }
                 else {
-                    insert_tree_multiset(root_->right, new_node);
+                    if (node->right == nullptr) return { nullptr, node, false };
+                    node = node->right;
                 }
             }
-            balance(new_node);
         }
 
-        void insert_tree_multiset(const Key k) {
-            std::pair<Key, T> val = { k, 0 };
-            tree_el_<Key, T>* new_node =
-                new tree_el_<Key, T>(val, Red, nullptr, nullptr, nullptr);
+        //  right before hint when the order allows it, else after the equal keys
+        insert_pos_ find_insert_equal_pos(tree_el_<Key, T>* hint,
+            const Key& key) const {
+            if (root_ == nullptr || hint == nullptr || hint == end_ ||
+                compare_(hint->key(), key)) {
+                return find_insert_equal_pos(key);
+            }
+            if (hint == end_->right) return { nullptr, hint, true };
+            tree_el_<Key, T>* before = prev_tree(hint);
+            if (compare_(key, before->key())) return find_insert_equal_pos(key);
+            if (hint->left == nullptr) return { nullptr, hint, true };
+            return { nullptr, before, false };
+        }
 
-            if (empty()) {
-                root_ = new_node;
-                if (end_ == nullptr) {
-                    end_ = new tree_el_<Key, T>(val, Red, nullptr, new_node, new_node);
+        template <typename... Args>
+        tree_el_<Key, T>* emplace_equal_tree(tree_el_<Key, T>* hint,
+            Args&&... args) {
+            tree_el_<Key, T>* node = create_node(std::forward<Args>(args)...);
+            return link_node(node, find_insert_equal_pos(hint, node->key()));
+        }
+
+        //  inserts without a uniqueness check
+        void insert_tree(node_value_type val) {
+            emplace_equal_tree(nullptr, std::move(val));
+        }
+
+        // for multiset
+        void insert_tree_multiset(node_value_type val) {
+            insert_tree(std::move(val));
+        }
+
+        //  red-black fixup after linking a red leaf
+        void balance(tree_el_<Key, T>* node) {
+            while (node != root_ && node->parent->color == Red) {
+                tree_el_<Key, T>* parent = node->parent;
+                tree_el_<Key, T>* grand = parent->parent;
+                if (parent == grand->left) {
+                    tree_el_<Key, T>* uncle = grand->right;
+                    if (uncle && uncle->color == Red) {
+                        parent->color = Black;
+                        uncle->color = Black;
+                        grand->color = Red;
+                        node = grand;
+                    }
+                    else {
+                        if (node == parent->right) {
+                            node = parent;
+                            left_turn(node);
+                            parent = node->parent;
+                        }
+                        parent->color = Black;
+                        grand->color = Red;
+                        right_turn(grand);
+                    }
+                }
+                else {
+                    tree_el_<Key, T>* uncle = grand->left;
+                    if (uncle && uncle->color == Red) {
+                        parent->color = Black;
+                        uncle->color = Black;
+                        grand->color = Red;
+                        node = grand;
+                    }
+                    else {
+                        if (node == parent->left) {
+                            node = parent;
+                            right_turn(node);
+                            parent = node->parent;
+                        }
+                        parent->color = Black;
+                        grand->color = Red;
+                        left_turn(grand);
+                    }
                 }
             }
-            else {
-                insert_tree_multiset(root_, new_node);
+            root_->color = Black;
+        }
 
-                if (new_node->values.first > end_->left->values.first) {
-                    end_->left = new_node;
+        //  unlink node from the tree, rebalance and free it
+        void erase_tree(tree_el_<Key, T>* node) {
+            destroy_node(unlink_tree(node));
+        }
+
+        //  unlink node from the tree and rebalance; the node keeps its value
+        //  and comes back with cleared links, ready for link_node
+        tree_el_<Key, T>* unlink_tree(tree_el_<Key, T>* node) {
+            if (size_ == 1) {
+                destroy_end(end_);
+                root_ = nullptr;
+                end_ = nullptr;
+                size_ = 0;
+                return reset_links(node);
+            }
+#ifdef S21_THREADED_TREE
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+            if (end_->right == node) end_->right = node->next;
+            if (end_->left == node) end_->left = node->prev;
+#else
+            if (end_->right == node) end_->right = next_tree(node);
+            if (end_->left == node) end_->left = prev_tree(node);
+#endif
+
+            // y is the node that leaves its place: node itself or its successor
+            tree_el_<Key, T>* y = node;
+            if (node->left && node->right) {
+                y = node->right;
+                while (y->left) y = y->left;
+            }
+            for (auto p = y->parent; p != nullptr; p = p->parent) {
+                --p->size;
+            }
+
+            tree_el_<Key, T>* x = y->left ? y->left : y->right;
+            tree_el_<Key, T>* x_parent = nullptr;
+            TreeColor removed = y->color;
+
+            if (y != node) {
+                node->left->parent = y;
+                y->left = node->left;
+                if (y != node->right) {
+                    x_parent = y->parent;
+                    if (x) x->parent = y->parent;
+                    y->parent->left = x;
+                    y->right = node->right;
+                    node->right->parent = y;
                 }
-                if (new_node->values.first < end_->right->values.first) {
-                    end_->right = new_node;
+                else {
+                    x_parent = y;
                 }
+                replace_child(node, y);
+                y->color = node->color;
+                y->size = node->size;
             }
-            root_->color = Black;
+            else {
+                x_parent = node->parent;
+                if (x) x->parent = node->parent;
+                replace_child(node, x);
+            }
+
+            refresh_path_tree(x_parent);
+            if (removed == Black) erase_balance(x, x_parent);
+            --size_;
+            return reset_links(node);
         }
 
-        void balance(tree_el_<Key, T>* new_node) {
-            if (new_node) {
-                if (new_node->parent != nullptr) {
-                    if (new_node->color == Red && new_node == new_node->parent->right &&
-                        ((new_node->parent->left == nullptr) ||
-                            (new_node->parent->left->color == Black))) {
-                        left_turn(root_, new_node->parent);
-                    }
+        static tree_el_<Key, T>* reset_links(tree_el_<Key, T>* node) noexcept {
+            node->color = Red;
+            node->parent = node->left = node->right = nullptr;
+            node->size = 1;
+#ifdef S21_THREADED_TREE
+            node->next = node->prev = nullptr;
+#endif
+            return node;
+        }
 
-                    else if (new_node->parent->parent != nullptr) {
-                        if (new_node->color == Red && new_node->parent->color == Red &&
-                            new_node == new_node->parent->left &&
-                            new_node->parent == new_node->parent->parent->left) {
-                            right_turn(root_, new_node->parent->parent);
+        //  node handles
+        node_type extract_tree(tree_el_<Key, T>* node) {
+            return node_type(unlink_tree(node), node_allocator_);
+        }
+
+        //  relinks the handle's node when can_relink allows it, otherwise the
+        //  value moves into a node of ours; on a clash the handle keeps it
+        std::pair<tree_el_<Key, T>*, bool> insert_node_tree(tree_el_<Key, T>* hint,
+            node_type& handle, bool unique = true) {
+            if (handle.empty()) return { nullptr, false };
+            insert_pos_ pos = unique ? find_insert_pos(hint, handle.key())
+                : find_insert_equal_pos(hint, handle.key());
+            if (pos.node) return { pos.node, false };
+            tree_el_<Key, T>* node = nullptr;
+            if (can_relink(*handle.alloc_)) {
+                node = std::exchange(handle.node_, nullptr);
+                handle.alloc_.reset();
+            }
+            else {
+                node = create_node(std::move(handle.node_->values));
+                handle.reset();
+            }
+            return { link_node(node, pos), true };
+        }
+
+        //  red-black fixup for a "doubly black" x hanging under x_parent
+        void erase_balance(tree_el_<Key, T>* x, tree_el_<Key, T>* x_parent) {
+            while (x != root_ && (x == nullptr || x->color == Black)) {
+                if (x == x_parent->left) {
+                    tree_el_<Key, T>* w = x_parent->right;
+                    if (w->color == Red) {
+                        w->color = Black;
+                        x_parent->color = Red;
+                        left_turn(x_parent);
+                        w = x_parent->right;
+                    }
+                    if (is_black(w->left) && is_black(w->right)) {
+                        w->color = Red;
+                        x = x_parent;
+                        x_parent = x_parent->parent;
+                    }
+                    else {
+                        if (is_black(w->right)) {
+                            w->left->color = Black;
+                            w->color = Red;
+                            right_turn(w);
+                            w = x_parent->right;
                         }
+                        w->color = x_parent->color;
+                        x_parent->color = Black;
+                        if (w->right) w->right->color = Black;
+                        left_turn(x_parent);
+                        break;
                     }
-
-                    if (new_node->parent != nullptr) {
-                        if (new_node->parent->left && new_node->parent->right &&
-                            (new_node->parent->color == Black)) {
-                            if ((new_node->parent->left->color == Red) &&
-                                (new_node->parent->right->color == Red)) {
-                                new_node->parent->color = Red;
-                                new_node->parent->left->color = Black;
-                                new_node->parent->right->color = Black;
-                            }
+                }
+                else {
+                    tree_el_<Key, T>* w = x_parent->left;
+                    if (w->color == Red) {
+                        w->color = Black;
+                        x_parent->color = Red;
+                        right_turn(x_parent);
+                        w = x_parent->left;
+                    }
+                    if (is_black(w->left) && is_black(w->right)) {
+                        w->color = Red;
+                        x = x_parent;
+                        x_parent = x_parent->parent;
+                    }
+                    else {
+                        if (is_black(w->left)) {
+                            w->right->color = Black;
+                            w->color = Red;
+                            left_turn(w);
+                            w = x_parent->left;
                         }
+                        w->color = x_parent->color;
+                        x_parent->color = Black;
+                        if (w->left) w->left->color = Black;
+                        right_turn(x_parent);
+                        break;
                     }
-
-                    balance(new_node->parent);
                 }
             }
+            if (x) x->color = Black;
+        }
+
+        static bool is_black(const tree_el_<Key, T>* node) noexcept {
+            return node == nullptr || node->color == Black;
         }
 
-        void left_turn(tree_el_<Key, T>*& root_, tree_el_<Key, T>* x) {
-            x->color = Red;
-            x->right->color = Black;
+        //  put replacement where node hangs from its parent (or the root)
+        void replace_child(tree_el_<Key, T>* node,
+            tree_el_<Key, T>* replacement) noexcept {
+            if (node->parent == nullptr)
+                root_ = replacement;
+            else if (node == node->parent->left)
+                node->parent->left = replacement;
+            else
+                node->parent->right = replacement;
+            if (replacement) replacement->parent = node->parent;
+        }
 
+        void left_turn(tree_el_<Key, T>* x) {
             tree_el_<Key, T>* y = x->right;
             x->right = y->left;
             if (y->left != NULL) y->left->parent = x;
 
-            y->parent = x->parent;
-            if (x->parent == NULL)
-                root_ = y;
-            else {
-                if (x == x->parent->left)
-                    x->parent->left = y;
-                else
-                    x->parent->right = y;
-            }
+            replace_child(x, y);
             y->left = x;
             x->parent = y;
-        }
 
-        void right_turn(tree_el_<Key, T>*& root_, tree_el_<Key, T>* y) {
-            y->color = Red;
-            y->left->color = Black;
+            y->size = x->size;
+            update_size(x);
+            tree_augment_<Key, T>::update(x);
+            tree_augment_<Key, T>::update(y);
+        }
 
+        void right_turn(tree_el_<Key, T>* y) {
             tree_el_<Key, T>* x = y->left;
             y->left = x->right;
             if (x->right != NULL) x->right->parent = y;
 
-            x->parent = y->parent;
-            if (y->parent == NULL)
-                root_ = x;
-            else {
-                if (y == y->parent->right)
-                    y->parent->right = x;
-                else
-                    y->parent->left = x;
-            }
+            replace_child(y, x);
             x->right = y;
             y->parent = x;
+
+            x->size = y->size;
+            update_size(y);
+            tree_augment_<Key, T>::update(y);
+            tree_augment_<Key, T>::update(x);
         }
 
         //  print tree
@@ -285,103 +1255,156 @@ namespace s21 {
         }
 
     private:
+        //  preorder walk over parent links, no recursion
         void print(tree_el_<Key, T>* node) const {
-            if (node == NULL) return;
-            if (node->parent == NULL)
-                std::cout << "\n"
-                << node->values.first << "(" << node->color << ") is a root"
-                << std::endl;
-            else if (node->parent->left == node) {
-                std::cout << node->values.first << "(" << node->color << ") is "
-                    << node->parent->values.first << "'s "
-                    << "left child" << std::endl;
-            }
-            else {
-                std::cout << node->values.first << "(" << node->color << ") is "
-                    << node->parent->values.first << "'s "
-                    << "right child" << std::endl;
+            while (node != nullptr) {
+                if (node->parent == nullptr)
+                    std::cout << "\n"
+                    << node->key() << "(" << node->color << ") is a root"
+                    << std::endl;
+                else if (node->parent->left == node) {
+                    std::cout << node->key() << "(" << node->color << ") is "
+                        << node->parent->key() << "'s "
+                        << "left child" << std::endl;
+                }
+                else {
+                    std::cout << node->key() << "(" << node->color << ") is "
+                        << node->parent->key() << "'s "
+                        << "right child" << std::endl;
+                }
+                if (node->left) {
+                    node = node->left;
+                    continue;
+                }
+                if (node->right) {
+                    node = node->right;
+                    continue;
+                }
+                // climb until some ancestor has a right subtree not yet seen
+                tree_el_<Key, T>* parent = node->parent;
+                while (parent && (parent->right == node || parent->right == nullptr)) {
+                    node = parent;
+                    parent = parent->parent;
+                }
+                node = parent ? parent->right : nullptr;
             }
-            print(node->left);
-            print(node->right);
         }
 
     public:
-        tree_el_<Key, T>* search_tree(tree_el_<Key, T>* node, const Key& key) {
-            while (node != NULL) {
-                if (node->values.first == key) {
-                    return node;
-
-                }
-                else if (key < node->values.first && node->left) {
+        template <typename K>
+        tree_el_<Key, T>* search_tree(tree_el_<Key, T>* node, const K& key) const {
+            while (node != nullptr) {
+                if (compare_(key, node->key())) {
                     node = node->left;
-
                 }
-                else if (key > node->values.first && node->right) {
+                else if (compare_(node->key(), key)) {
                     node = node->right;
-
                 }
                 else {
-                    break;
+                    return node;
                 }
             }
             return nullptr;
         }
 
-        //  for multiset
+        //  for multiset: the first of the equal keys
+        template <typename K>
         tree_el_<Key, T>* search_tree_multiset(tree_el_<Key, T>* node,
-            const Key& key) {
-            int cnt = 0;
-            while (node != NULL) {
-                if (node->values.first == key) {
-                    ++cnt;
-                    if (cnt == count_multiset(node, key)) {
-                        return node;
-                    }
+            const K& key) const {
+            tree_el_<Key, T>* found = nullptr;
+            while (node != nullptr) {
+                if (compare_(node->key(), key)) {
+                    node = node->right;
+                }
+                else {
+                    if (!compare_(key, node->key())) found = node;
+                    node = node->left;
+                }
+            }
+            return found;
+        }
 
+        //  first element not less than key, nullptr if there is none
+        template <typename K>
+        tree_el_<Key, T>* lower_bound_tree(const K& key) const {
+            tree_el_<Key, T>* node = root_;
+            tree_el_<Key, T>* found = nullptr;
+            while (node != nullptr) {
+                if (compare_(node->key(), key)) {
+                    node = node->right;
                 }
-                else if (key < node->values.first && node->left) {
+                else {
+                    found = node;
                     node = node->left;
+                }
+            }
+            return found;
+        }
 
+        //  first element greater than key, nullptr if there is none
+        template <typename K>
+        tree_el_<Key, T>* upper_bound_tree(const K& key) const {
+            tree_el_<Key, T>* node = root_;
+            tree_el_<Key, T>* found = nullptr;
+            while (node != nullptr) {
+                if (compare_(key, node->key())) {
+                    found = node;
+                    node = node->left;
                 }
-                else if (key > node->values.first && node->right) {
+                else {
                     node = node->right;
                 }
             }
-            return nullptr;
+            return found;
+        }
+
+        template <typename K>
+        bool contains_tree(tree_el_<Key, T>* node, const K& key) const {
+            return (search_tree(node, key)) ? true : false;
         }
 
-        Key upper_bound_tree_multiset(tree_el_<Key, T>* node, const Key& key) {
-            while (node != NULL) {
-                if (key <= node->values.first) {
-                    if (node->left) {
-                        if ((node->values.first - key) > (key - node->left->values.first) &&
-                            (key != node->left->values.first)) {
+        //  search_tree for a batch: up to BATCH_LOOKUP_WIDTH descents take one
+        //  level per round and prefetch their next node, which then loads
+        //  while the other descents step; emit(key, node or nullptr) in order
+        template <typename ForwardIt, typename Emit>
+        void search_batch_tree(ForwardIt first, ForwardIt last, Emit&& emit) const {
+            while (first != last) {
+                ForwardIt queries[defines::BATCH_LOOKUP_WIDTH];
+                tree_el_<Key, T>* nodes[defines::BATCH_LOOKUP_WIDTH];
+                tree_el_<Key, T>* found[defines::BATCH_LOOKUP_WIDTH];
+                size_type width = 0;
+                for (; width < defines::BATCH_LOOKUP_WIDTH && first != last;
+                    ++first, ++width) {
+                    queries[width] = first;
+                    nodes[width] = root_;
+                    found[width] = nullptr;
+                }
+                for (size_type active = width; active != 0;) {
+                    active = 0;
+                    for (size_type q = 0; q < width; ++q) {
+                        tree_el_<Key, T>* node = nodes[q];
+                        if (node == nullptr) continue;
+                        if (compare_(*queries[q], node->key())) {
                             node = node->left;
                         }
+                        else if (compare_(node->key(), *queries[q])) {
+                            node = node->right;
+                        }
                         else {
-                            return node->values.first;
+                            found[q] = node;
+                            node = nullptr;
                         }
+                        if (node) {
+                            S21_PREFETCH(node);
+                            ++active;
+                        }
+                        nodes[q] = node;
                     }
-                    else {
-                        return node->values.first;
-                    }
-
                 }
-                else if (key > node->values.first) {
-                    if (node->right) {
-                        node = node->right;
-                    }
-                    else {
-                        return Key();
-                    }
+                for (size_type q = 0; q < width; ++q) {
+                    emit(*queries[q], found[q]);
                 }
             }
-            return Key();
-        }
-
-        bool contains_tree(tree_el_<Key, T>* node, const Key& key) {
-            node = nullptr;
-            return (search_tree(root_, key)) ? true : false;
         }
     };
 }  // namespace s21
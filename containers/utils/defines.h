@@ -6,11 +6,19 @@
 #include <algorithm>
 #include <initializer_list>
 #include <exception>
+#include <utility>
 
 // потом сделать через флаг в cmake
 #define SWITCH_MODIFIRE
 #define THROW_FURTHER throw
 
+// подсказка заранее загрузить строку кэша; без GCC и Clang ничего не делает
+#if defined(__GNUC__)
+#define S21_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define S21_PREFETCH(address) ((void)(address))
+#endif
+
 /*
  * дефайн для того чтобы в тестах можно было унаследоваться от класса
  * и получить доступ к его приватным функциям и членам
@@ -22,11 +30,25 @@
 #define MODIFIRE private
 #endif
 
+/*
+ * -DS21_THREADED_TREE: узлы деревьев дополнительно хранят ссылки next/prev
+ * на соседей по порядку, замкнутые в кольцо через end_. Итераторы делают
+ * ++ и -- за один переход по указателю, цена - два указателя на узел
+ */
+
 namespace s21::defines {
 constexpr int DEFAULT_HEIGHT = 1;
+constexpr int SKIPLIST_MAX_HEIGHT = 32;
+constexpr std::size_t SKIPLIST_READER_STRIPES = 16;
+constexpr std::size_t SKIPLIST_RECLAIM_BATCH = 64;
 constexpr std::size_t DEFAULT_TABLE_SIZE = 32;
 constexpr std::size_t DEFAULT_CAPACITY = 5;
 constexpr std::size_t FACTOR = 2;
+constexpr std::size_t POOL_SLAB_BLOCKS = 64;
+constexpr std::size_t POOL_MAX_SLAB_BLOCKS = 4096;
+constexpr std::size_t BTREE_NODE_BYTES = 256;
+constexpr std::size_t CONCURRENT_SHARDS = 16;
+constexpr std::size_t BATCH_LOOKUP_WIDTH = 16;
 constexpr bool NON_CONST = false;
 constexpr bool CONST = true;
 } // namespace own::defines
@@ -0,0 +1,265 @@
+#ifndef POOL_ALLOCATOR_HPP_
+#define POOL_ALLOCATOR_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "defines.h"
+
+namespace s21 {
+/*
+ * Пул блоков одного размера: память нарезается из больших слэбов, а
+ * освобожденные блоки уходят в односвязный free list и переиспользуются.
+ * Размер блока фиксируется первым одиночным allocate. Пул не потокобезопасен,
+ * у каждого контейнера он свой.
+ * Слэбы лежат в отдельном хранилище под shared_ptr: пул, принявший через
+ * adopt() блоки другого пула (узел переехал в чужое дерево без
+ * перевыделения), держит его хранилища, и память живет, пока жив любой из
+ * них. Хранилища ни на что не ссылаются, поэтому циклов владения нет
+ */
+class node_pool {
+ private:
+  struct free_block {
+    free_block* next;
+  };
+
+  struct slab {
+    slab* next;
+  };
+
+  struct slab_store {
+    slab* slabs = nullptr;
+
+    ~slab_store() {
+      while (slabs) {
+        slab* next = slabs->next;
+        ::operator delete(slabs);
+        slabs = next;
+      }
+    }
+  };
+
+  // список только растет с головы, узлы после публикации не меняются
+  struct adopted_store {
+    std::shared_ptr<slab_store> store;
+    adopted_store* next;
+  };
+
+ public:
+  node_pool() noexcept = default;
+
+  node_pool(const node_pool&) = delete;
+  node_pool& operator=(const node_pool&) = delete;
+
+  ~node_pool() {
+    for (adopted_store* it = adopted_.load(std::memory_order_relaxed); it;) {
+      adopted_store* next = it->next;
+      delete it;
+      it = next;
+    }
+  }
+
+  static constexpr std::size_t block_size_for(std::size_t t_size) noexcept {
+    constexpr std::size_t align = alignof(std::max_align_t);
+    std::size_t size = t_size < sizeof(free_block) ? sizeof(free_block) : t_size;
+    return (size + align - 1) / align * align;
+  }
+
+  // пул обслуживает только один размер блока
+  bool serves(std::size_t t_size) noexcept {
+    if (block_size_ == 0) {
+      block_size_ = block_size_for(t_size);
+    }
+    return block_size_ == block_size_for(t_size);
+  }
+
+  /*
+   * следующие t_count блоков выдаются подряд из одного слэба, минуя free list,
+   * чтобы пакетная сборка дерева получила узлы в непрерывной памяти
+   */
+  void reserve(std::size_t t_count) {
+    std::size_t left = static_cast<std::size_t>(slab_end_ - cursor_);
+    if (left < t_count * block_size_) {
+      for (; cursor_ != slab_end_; cursor_ += block_size_) {
+        give(cursor_);
+      }
+      grow(t_count);
+    }
+    reserved_ = t_count;
+  }
+
+  void* take() {
+    if (reserved_) {
+      --reserved_;
+    } else if (free_) {
+      free_block* block = free_;
+      free_ = free_->next;
+      return block;
+    }
+    if (cursor_ == slab_end_) {
+      grow();
+    }
+    void* block = cursor_;
+    cursor_ += block_size_;
+    return block;
+  }
+
+  void give(void* t_block) noexcept {
+    free_block* block = static_cast<free_block*>(t_block);
+    block->next = free_;
+    free_ = block;
+  }
+
+  /*
+   * блоки t_other (и пулов, которые он сам принял) могут приходить в give()
+   * этого пула: их хранилища живут, пока жив этот пул. Блоки должны быть
+   * того же размера, это проверяет аллокатор
+   */
+  void adopt(const node_pool& t_other) {
+    hold(t_other.store_);
+    for (adopted_store* it = t_other.adopted_.load(std::memory_order_acquire);
+         it; it = it->next) {
+      hold(it->store);
+    }
+  }
+
+ private:
+  void hold(const std::shared_ptr<slab_store>& t_store) {
+    if (!t_store || t_store == store_) return;
+    adopted_store* head = adopted_.load(std::memory_order_relaxed);
+    for (adopted_store* it = head; it; it = it->next) {
+      if (it->store == t_store) return;
+    }
+    adopted_.store(new adopted_store{t_store, head},
+                   std::memory_order_release);
+  }
+
+  void grow(std::size_t t_count = 0) {
+    constexpr std::size_t header = node_pool::block_size_for(sizeof(slab));
+    std::size_t blocks = t_count > slab_blocks_ ? t_count : slab_blocks_;
+    if (!store_) store_ = std::make_shared<slab_store>();
+    void* memory = ::operator new(header + blocks * block_size_);
+    store_->slabs = new (memory) slab{store_->slabs};
+    cursor_ = static_cast<char*>(memory) + header;
+    slab_end_ = cursor_ + blocks * block_size_;
+    if (slab_blocks_ < defines::POOL_MAX_SLAB_BLOCKS) {
+      slab_blocks_ *= defines::FACTOR;
+    }
+  }
+
+  std::size_t block_size_ = 0;
+  std::size_t slab_blocks_ = defines::POOL_SLAB_BLOCKS;
+  std::size_t reserved_ = 0;
+  free_block* free_ = nullptr;
+  std::shared_ptr<slab_store> store_;
+  std::atomic<adopted_store*> adopted_{nullptr};
+  char* cursor_ = nullptr;
+  char* slab_end_ = nullptr;
+};
+
+/*
+ * Аллокатор узлов для деревьев. Одиночные объекты берутся из node_pool,
+ * массивы и переразмеренные типы идут напрямую в operator new. Копии и
+ * rebind-копии делят один пул, копия контейнера получает новый пул.
+ */
+template <typename T>
+class pool_allocator {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using reference = T&;
+  using const_reference = const T&;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  template <typename U>
+  struct rebind {
+    using other = pool_allocator<U>;
+  };
+
+ public:
+  pool_allocator() : pool_(std::make_shared<node_pool>()) {}
+
+  template <typename U>
+  pool_allocator(const pool_allocator<U>& t_other) noexcept
+      : pool_(t_other.pool_) {}
+
+  [[nodiscard]] pointer allocate(size_type t_n) {
+    if (pooled(t_n)) {
+      return static_cast<pointer>(pool_->take());
+    }
+    return static_cast<pointer>(::operator new(t_n * sizeof(T)));
+  }
+
+  void deallocate(pointer t_ptr, size_type t_n) noexcept {
+    if (pooled(t_n)) {
+      pool_->give(t_ptr);
+    } else {
+      ::operator delete(t_ptr);
+    }
+  }
+
+  // подсказка контейнеру: следующие t_n одиночных allocate пойдут подряд
+  void reserve(size_type t_n) {
+    if (pooled(1)) {
+      pool_->reserve(t_n);
+    }
+  }
+
+  node_pool* resource() const noexcept { return pool_.get(); }
+
+  /*
+   * после true узлы, выделенные t_other, можно освобождать через этот
+   * аллокатор: деревья перевешивают такие узлы, не копируя значения. false,
+   * если один из пулов не выдает блоки такого размера
+   */
+  template <typename U>
+  bool adopt(const pool_allocator<U>& t_other) {
+    if (!pooled(1) || !t_other.pooled(1) || sizeof(T) != sizeof(U)) {
+      return false;
+    }
+    pool_->adopt(*t_other.pool_);
+    return true;
+  }
+
+  pool_allocator select_on_container_copy_construction() const {
+    return pool_allocator();
+  }
+
+  size_type max_size() const noexcept {
+    return std::allocator_traits<std::allocator<T>>::max_size(
+        std::allocator<T>());
+  }
+
+  template <typename U>
+  friend bool operator==(const pool_allocator& t_lhs,
+                         const pool_allocator<U>& t_rhs) noexcept {
+    return t_lhs.resource() == t_rhs.resource();
+  }
+
+  template <typename U>
+  friend bool operator!=(const pool_allocator& t_lhs,
+                         const pool_allocator<U>& t_rhs) noexcept {
+    return !(t_lhs == t_rhs);
+  }
+
+ private:
+  bool pooled(size_type t_n) const noexcept {
+    return t_n == 1 && alignof(T) <= alignof(std::max_align_t) &&
+           pool_->serves(sizeof(T));
+  }
+
+  template <typename U>
+  friend class pool_allocator;
+
+  std::shared_ptr<node_pool> pool_;
+};
+}  // namespace s21
+
+#endif
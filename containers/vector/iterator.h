@@ -25,13 +25,13 @@ struct iterator_wrapper {
  public:
   constexpr iterator_wrapper() noexcept : m_data(nullptr) {}
 
-  constexpr iterator_wrapper(pointer t_ptr) noexcept : m_data(t_ptr) {}
+  constexpr iterator_wrapper(meta_pointer t_ptr) noexcept : m_data(t_ptr) {}
 
   constexpr iterator_wrapper(const iterator_wrapper<T, false>& t_iter)
-      : m_data(&(*t_iter)) {}
+      : m_data(t_iter.operator->()) {}
 
   constexpr iterator_wrapper(const iterator_wrapper<T, true>& t_iter)
-      : m_data(const_cast<T*>(&(*t_iter))) {}
+      : m_data(const_cast<T*>(t_iter.operator->())) {}
 
  public:
   constexpr iterator& operator++() noexcept {
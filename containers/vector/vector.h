@@ -43,7 +43,7 @@ class vector {
   constexpr vector(std::size_t t_size, const_reference t_element)
       : size_(t_size), capacity_(t_size * FACTOR) {
     data_ = allocator_.allocate(capacity_);
-    fill(t_element);
+    std::uninitialized_fill(data_, data_ + size_, t_element);
   }
 
   constexpr vector(const std::initializer_list<T>& t_list)
@@ -73,20 +73,48 @@ class vector {
     initialize(std::forward<CC>(t_vector));
   }
 
-  ~vector() { allocator_.deallocate(data_, capacity_); }
+  /*
+   * шаблон выше не считается копирующим конструктором, без этих двух
+   * компилятор сгенерировал бы поверхностную копию указателя data_
+   */
+  constexpr vector(const vector& t_vector) { initialize(t_vector); }
+
+  constexpr vector(vector&& t_vector) noexcept {
+    initialize(std::move(t_vector));
+  }
+
+  ~vector() {
+    clear();
+    allocator_.deallocate(data_, capacity_);
+  }
 
  public:
   template <typename TT, typename = std::enable_if_t<std::is_same_v<
                              vector, std::remove_reference_t<TT>>>>
   constexpr vector& operator=(TT&& t_vector) {
     if (this != &t_vector) {
-      allocator_.deallocate(data_, size_);
+      clear();
+      allocator_.deallocate(data_, capacity_);
       initialize(std::forward<TT>(t_vector));
     }
 
     return *this;
   }
 
+  constexpr vector& operator=(const vector& t_vector) {
+    if (this != &t_vector) {
+      clear();
+      allocator_.deallocate(data_, capacity_);
+      initialize(t_vector);
+    }
+
+    return *this;
+  }
+
+  constexpr vector& operator=(vector&& t_vector) noexcept {
+    return operator=<vector>(std::move(t_vector));
+  }
+
   const_reference operator[](size_type t_i) const {
     if (t_i >= size_) {
       throw std::out_of_range("index out of range.\n");
@@ -104,9 +132,14 @@ class vector {
   }
 
  protected:
+  // пустой или перемещенный вектор имеет нулевую емкость
+  constexpr std::size_t grown_capacity() const noexcept {
+    return size_ ? size_ * FACTOR : DEFAULT_CAPACITY;
+  }
+
   template <typename Iter>
   void safe_cpy(Iter t_from, Iter t_to, std::size_t t_size) {
-    if (!t_from || !t_to) {
+    if (t_size && (!t_from || !t_to)) {
       throw std::invalid_argument("invalid iterator provided.\n");
     }
 
@@ -119,6 +152,16 @@ class vector {
     }
   }
 
+  // копия не должна опустошать исходный вектор, поэтому copy, а не move
+  void safe_copy(const_pointer t_from, pointer t_to, std::size_t t_size) {
+    try {
+      std::uninitialized_copy(t_from, t_from + t_size, t_to);
+    } catch (...) {
+      allocator_.deallocate(t_to, capacity_);
+      THROW_FURTHER;
+    }
+  }
+
   template <typename Y>
   constexpr void initialize(Y&& t_vector) noexcept(
       !std::is_lvalue_reference_v<Y>) {
@@ -127,7 +170,7 @@ class vector {
       capacity_ = t_vector.capacity_;
       allocator_ = t_vector.allocator_;
       data_ = allocator_.allocate(capacity_);
-      safe_cpy(t_vector.data_, data_, size_);
+      safe_copy(t_vector.data_, data_, size_);
     } else {
       size_ = std::exchange(t_vector.size_, 0);
       capacity_ = std::exchange(t_vector.capacity_, 0);
@@ -221,7 +264,7 @@ class vector {
   template <typename... Args>
   constexpr reference emplace_back(Args&&... t_args) {
     if (capacity_ == size_) {
-      reserve(size_ * FACTOR);
+      reserve(grown_capacity());
     }
     // не использую allocator.construct для практики с new placement
     return *new (data_ + size_++) T(std::forward<Args>(t_args)...);
@@ -230,7 +273,7 @@ class vector {
   template <typename PP>
   void push_back(PP&& t_elem) {
     if (capacity_ == size_) {
-      reserve(size_ * FACTOR);
+      reserve(grown_capacity());
     }
     new (data_ + size_++) T(std::forward<PP>(t_elem));
   }
@@ -252,6 +295,7 @@ class vector {
   constexpr void reserve(std::size_t t_size) {
     auto new_arr = allocator_.allocate(t_size);
     safe_cpy(data_, new_arr, size_);
+    std::destroy(data_, data_ + size_);
     allocator_.deallocate(data_, capacity_);
     data_ = std::exchange(new_arr, nullptr);
     capacity_ = t_size;
@@ -267,7 +311,7 @@ class vector {
 
   template <typename II>
   iterator insert(const_iterator t_pos, II&& t_elem) {
-    auto pos = std::distance(cbegin(), t_pos);
+    auto pos = static_cast<std::size_t>(std::distance(cbegin(), t_pos));
     if (pos > size_) {
       throw std::out_of_range("iterator position are out of range.\n");
     }
@@ -277,24 +321,31 @@ class vector {
       reserve(new_size * FACTOR);
     }
 
-    for (auto i = size_; i > pos; i--) {
-      data_[i] = std::move(data_[i - 1]);
-    };
-    new (data_ + pos) T(std::forward<II>(t_elem));
+    if (pos == size_) {
+      new (data_ + size_) T(std::forward<II>(t_elem));
+    } else {
+      // элемент собирается заранее: t_elem может ссылаться внутрь вектора
+      T elem(std::forward<II>(t_elem));
+      new (data_ + size_) T(std::move(data_[size_ - 1]));
+      for (auto i = size_ - 1; i > pos; i--) {
+        data_[i] = std::move(data_[i - 1]);
+      }
+      data_[pos] = std::move(elem);
+    }
     size_++;
     return iterator(data_ + pos);
   }
 
   void erase(iterator t_pos) {
-    auto pos = std::distance(begin(), t_pos);
-    if (pos > size_) {
+    auto pos = static_cast<std::size_t>(std::distance(begin(), t_pos));
+    if (pos >= size_) {
       throw std::out_of_range("iterator position are out of range.\n");
     }
 
     for (auto i = pos; i < size_ - 1; i++) {
       data_[i] = std::move(data_[i + 1]);
     }
-    size_--;
+    (data_ + --size_)->~T();
   }
 
   template <typename Y>
@@ -317,7 +368,7 @@ class vector {
     size_ = 0;
   }
 
-  void swap(vector<T>& t_other) {
+  void swap(vector& t_other) {
     std::swap(data_, t_other.data_);
     std::swap(size_, t_other.size_);
     std::swap(capacity_, t_other.capacity_);